@@ -0,0 +1,47 @@
+#include <benchmark/benchmark.h>
+#include <utils/dot_product.hpp>
+
+#include <random>
+#include <vector>
+
+namespace {
+
+using namespace utils::simd;
+
+// Same dimension as the bundled word2vec model
+constexpr size_t kDimension = 300;
+
+std::vector<float> RandomVector(std::mt19937& rng) {
+  std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+  std::vector<float> values(kDimension);
+  for (auto& value : values) {
+    value = dist(rng);
+  }
+  return values;
+}
+
+using DotKernel = float (*)(const float*, const float*, size_t) noexcept;
+
+void BM_Dot(benchmark::State& state, DotKernel dot, utils::cpu::Isa isa) {
+  if (!utils::cpu::IsSupported(isa)) {
+    state.SkipWithError("instruction set is not supported by this CPU");
+    return;
+  }
+
+  std::mt19937 rng(42);
+  const auto lhs = RandomVector(rng);
+  const auto rhs = RandomVector(rng);
+  for ([[maybe_unused]] auto _ : state) {
+    benchmark::DoNotOptimize(dot(lhs.data(), rhs.data(), kDimension));
+  }
+}
+
+}  // namespace
+
+BENCHMARK_CAPTURE(BM_Dot, scalar, &detail::DotScalar, utils::cpu::Isa::kScalar);
+#if UTILS_CPU_DISPATCH
+BENCHMARK_CAPTURE(BM_Dot, sse2, &detail::DotSse2, utils::cpu::Isa::kSse2);
+BENCHMARK_CAPTURE(BM_Dot, avx2, &detail::DotAvx2, utils::cpu::Isa::kAvx2);
+BENCHMARK_CAPTURE(BM_Dot, avx512, &detail::DotAvx512, utils::cpu::Isa::kAvx512);
+#endif
+BENCHMARK_CAPTURE(BM_Dot, dispatched, &Dot, utils::cpu::ActiveIsa());
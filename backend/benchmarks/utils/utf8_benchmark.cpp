@@ -0,0 +1,94 @@
+#include <benchmark/benchmark.h>
+#include <utils/utf8.hpp>
+
+#include <fstream>
+#include <vector>
+
+namespace {
+
+using namespace utils::utf8;
+
+// Lines of the noun list, optionally with the first letter capitalized the way players type them
+std::vector<std::string> LoadNouns(bool capitalize) {
+  std::vector<std::string> words;
+  std::ifstream file(CONTEXTO_ASSETS_DIR "/big_russian_nouns.txt");
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.empty()) continue;
+    if (capitalize && line.size() >= 2 && static_cast<uint8_t>(line[0]) == 0xD0 &&
+        static_cast<uint8_t>(line[1]) >= 0xB0) {
+      line[1] = static_cast<char>(static_cast<uint8_t>(line[1]) - 0x20);  // а-п -> А-П
+    }
+    words.push_back(std::move(line));
+  }
+  return words;
+}
+
+const std::vector<std::string>& GetNouns(bool capitalize) {
+  static const std::vector<std::string> kLowerNouns = LoadNouns(false);
+  static const std::vector<std::string> kCapitalizedNouns = LoadNouns(true);
+  return capitalize ? kCapitalizedNouns : kLowerNouns;
+}
+
+// The implementation before vectorization: byte-by-byte into a freshly allocated string
+void Utf8ToLowerLegacy(benchmark::State& state) {
+  const auto& words = GetNouns(state.range(0) != 0);
+  for (auto _ : state) {
+    for (const auto& word : words) {
+      std::string result(word.size(), '\0');
+      detail::ToLowerScalar(word, result.data());
+      benchmark::DoNotOptimize(result);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(words.size()));
+}
+BENCHMARK(Utf8ToLowerLegacy)->Arg(0)->Arg(1);
+
+void Utf8ToLowerAllocating(benchmark::State& state) {
+  const auto& words = GetNouns(state.range(0) != 0);
+  for (auto _ : state) {
+    for (const auto& word : words) {
+      benchmark::DoNotOptimize(ToLower(word));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(words.size()));
+}
+BENCHMARK(Utf8ToLowerAllocating)->Arg(0)->Arg(1);
+
+void Utf8ToLowerIntoBuffer(benchmark::State& state) {
+  const auto& words = GetNouns(state.range(0) != 0);
+  std::array<char, 256> buffer{};
+  for (auto _ : state) {
+    for (const auto& word : words) {
+      ToLower(std::string_view(word).substr(0, buffer.size()), buffer.data());
+      benchmark::DoNotOptimize(buffer);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(words.size()));
+}
+BENCHMARK(Utf8ToLowerIntoBuffer)->Arg(0)->Arg(1);
+
+void Utf8ToLowerValidated(benchmark::State& state) {
+  const auto& words = GetNouns(state.range(0) != 0);
+  std::array<char, 256> buffer{};
+  for (auto _ : state) {
+    for (const auto& word : words) {
+      benchmark::DoNotOptimize(ToLowerValidated(std::string_view(word).substr(0, buffer.size()), buffer.data()));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(words.size()));
+}
+BENCHMARK(Utf8ToLowerValidated)->Arg(0)->Arg(1);
+
+void Utf8IsValid(benchmark::State& state) {
+  const auto& words = GetNouns(false);
+  for (auto _ : state) {
+    for (const auto& word : words) {
+      benchmark::DoNotOptimize(IsValid(word));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(words.size()));
+}
+BENCHMARK(Utf8IsValid);
+
+}  // namespace
@@ -0,0 +1,391 @@
+#!/bin/bash
+
+# Stop on errors
+set -e
+
+# Colors for output
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+YELLOW='\033[1;33m'
+BLUE='\033[0;34m'
+NC='\033[0m' # No Color
+
+SCRIPT_PATH="$(readlink -f "${BASH_SOURCE[0]}")"
+SCRIPT_DIR="$(dirname "$SCRIPT_PATH")"
+PROJECT_ROOT="$(dirname "$SCRIPT_DIR")"
+WORKLOAD_TOOLS="$(dirname "$PROJECT_ROOT")/utils/pgo_workload"
+
+# Default values
+COMPILER="gcc"
+CXX_COMPILER="g++"
+BUILD_SYSTEM="ninja"
+PARALLEL_JOBS=$(nproc 2>/dev/null || sysctl -n hw.ncpu 2>/dev/null || echo 4)
+PGO_DIR="$PROJECT_ROOT/build/pgo"
+ENABLE_BOLT=0
+SKIP_BASELINE=0
+WORKLOAD_WORDS=20000
+WORKLOAD_GAMES=2000
+TRAINING_PASSES=1
+BENCHMARK_DURATION=20
+BENCHMARK_WORKERS=$(nproc 2>/dev/null || echo 4)
+PORT=18080
+MONITOR_PORT=18085
+
+SERVER_PID=""
+
+print_info() {
+    echo -e "${BLUE}$1${NC}"
+}
+
+print_error() {
+    echo -e "${RED}Error: $1${NC}" >&2
+}
+
+print_success() {
+    echo -e "${GREEN}$1${NC}"
+}
+
+print_warning() {
+    echo -e "${YELLOW}Warning: $1${NC}"
+}
+
+print_help() {
+    echo "Contexto Profile-Guided Optimization Build Script"
+    echo "Usage: $0 [OPTIONS]"
+    echo ""
+    echo "Builds an instrumented Release binary, trains it on a synthetic game workload, rebuilds"
+    echo "it with the collected profile and compares the throughput against a plain Release build."
+    echo ""
+    echo "Options:"
+    echo "  -c, --compiler <name>     Compiler: gcc (default), clang"
+    echo "  -b, --build-system <name> Build system: ninja (default), make"
+    echo "  -j, --jobs <num>          Number of parallel jobs (default: detected CPU count)"
+    echo "  -d, --pgo-dir <dir>       Working directory (default: build/pgo)"
+    echo "      --bolt                Also post-link optimize the PGO binary with llvm-bolt"
+    echo "      --skip-baseline       Don't build and benchmark the non-PGO binary"
+    echo "      --words <num>         Vocabulary size of the synthetic embeddings (default: $WORKLOAD_WORDS)"
+    echo "      --games <num>         Games per guess trace (default: $WORKLOAD_GAMES)"
+    echo "      --passes <num>        Training passes over the guess trace (default: $TRAINING_PASSES)"
+    echo "      --duration <sec>      Benchmark duration per binary (default: $BENCHMARK_DURATION)"
+    echo "      --workers <num>       Concurrent benchmark players (default: detected CPU count)"
+    echo "      --port <num>          Port the server listens on during the runs (default: $PORT)"
+    echo "  -h, --help                Show this help message"
+}
+
+parse_args() {
+    while [[ $# -gt 0 ]]; do
+        case "$1" in
+            -h|--help)
+                print_help
+                exit 0
+                ;;
+            -c|--compiler)
+                COMPILER="$2"
+                if [[ "$COMPILER" == "gcc" ]]; then
+                    CXX_COMPILER="g++"
+                elif [[ "$COMPILER" == "clang" ]]; then
+                    CXX_COMPILER="clang++"
+                else
+                    print_error "Unsupported compiler: $COMPILER"
+                    exit 1
+                fi
+                shift 2
+                ;;
+            -b|--build-system)
+                BUILD_SYSTEM="$2"
+                shift 2
+                ;;
+            -j|--jobs)
+                PARALLEL_JOBS="$2"
+                shift 2
+                ;;
+            -d|--pgo-dir)
+                if [[ "${2:0:1}" != "/" ]]; then
+                    PGO_DIR="$(pwd)/$2"
+                else
+                    PGO_DIR="$2"
+                fi
+                shift 2
+                ;;
+            --bolt)
+                ENABLE_BOLT=1
+                shift
+                ;;
+            --skip-baseline)
+                SKIP_BASELINE=1
+                shift
+                ;;
+            --words)
+                WORKLOAD_WORDS="$2"
+                shift 2
+                ;;
+            --games)
+                WORKLOAD_GAMES="$2"
+                shift 2
+                ;;
+            --passes)
+                TRAINING_PASSES="$2"
+                shift 2
+                ;;
+            --duration)
+                BENCHMARK_DURATION="$2"
+                shift 2
+                ;;
+            --workers)
+                BENCHMARK_WORKERS="$2"
+                shift 2
+                ;;
+            --port)
+                PORT="$2"
+                MONITOR_PORT=$((PORT + 5))
+                shift 2
+                ;;
+            *)
+                print_error "Unknown option: $1"
+                print_help
+                exit 1
+                ;;
+        esac
+    done
+}
+
+check_dependencies() {
+    local tools=(cmake python3 curl "$CXX_COMPILER" "$BUILD_SYSTEM")
+    if [[ "$COMPILER" == "clang" ]]; then
+        tools+=(llvm-profdata)
+    fi
+    if [[ "$ENABLE_BOLT" -eq 1 ]]; then
+        tools+=(llvm-bolt)
+    fi
+
+    for tool in "${tools[@]}"; do
+        if ! command -v "$tool" &>/dev/null; then
+            print_error "$tool not found"
+            exit 1
+        fi
+    done
+}
+
+stop_server() {
+    if [[ -n "$SERVER_PID" ]]; then
+        # SIGTERM shuts the server down cleanly, which is when instrumented binaries write their profiles
+        kill -TERM "$SERVER_PID" 2>/dev/null || true
+        wait "$SERVER_PID" 2>/dev/null || true
+        SERVER_PID=""
+    fi
+}
+
+trap stop_server EXIT
+
+generate_workload() {
+    local workload_dir="$PGO_DIR/workload"
+    if [[ -f "$workload_dir/embeddings.vec" && -f "$workload_dir/benchmark_trace.txt" ]]; then
+        print_info "Reusing the synthetic workload in $workload_dir"
+        return
+    fi
+
+    print_info "Generating the synthetic workload..."
+    python3 "$WORKLOAD_TOOLS/generate_workload.py" \
+        --dictionary "$PROJECT_ROOT/assets/small_russian_nouns.txt" \
+        --output-dir "$workload_dir" \
+        --words "$WORKLOAD_WORDS" \
+        --games "$WORKLOAD_GAMES" \
+        --verbose
+}
+
+# The regular static config pointed at the synthetic workload, with quiet logging and private ports
+write_config() {
+    local workload_dir="$PGO_DIR/workload"
+    mkdir -p "$PGO_DIR/run/logs"
+
+    sed -e "s|embeddings-path: .*|embeddings-path: $workload_dir/embeddings.vec|" \
+        -e "s|dictionary-path: .*|dictionary-path: $workload_dir/dictionary.txt|" \
+        -e "s|blacklisted-words-path: .*|blacklisted-words-path: $PROJECT_ROOT/assets/blacklisted_words.txt|" \
+        -e "s|port: 8080|port: $PORT|" \
+        -e "s|port: 8085|port: $MONITOR_PORT|" \
+        -e "s|level: info|level: warning|" \
+        -e "s|log-level: INFO|log-level: WARNING|" \
+        "$PROJECT_ROOT/configs/static_config.yaml" > "$PGO_DIR/run/static_config.yaml"
+}
+
+# build_stage <name> <extra cmake args...>
+build_stage() {
+    local name=$1
+    shift
+    local build_dir="$PGO_DIR/$name"
+
+    print_info "Building the $name binary..."
+
+    local cmake_args=(
+        "-DCMAKE_BUILD_TYPE=Release"
+        "-DCMAKE_C_COMPILER=$COMPILER"
+        "-DCMAKE_CXX_COMPILER=$CXX_COMPILER"
+        "-DBUILD_TESTS=OFF"
+        "-DPGO_PROFILE_DIR=$PGO_DIR/profiles"
+        "$@"
+    )
+    if [[ "$BUILD_SYSTEM" == "ninja" ]]; then
+        cmake_args+=("-GNinja")
+    else
+        cmake_args+=("-G" "Unix Makefiles")
+    fi
+
+    cmake -S "$PROJECT_ROOT" -B "$build_dir" "${cmake_args[@]}" > "$PGO_DIR/$name.configure.log"
+    cmake --build "$build_dir" --parallel "$PARALLEL_JOBS"
+
+    # Every stage writes bin/Release/Contexto, so each result is copied aside
+    local project_name=$(grep -m 1 "set(PROJECT_NAME" "$PROJECT_ROOT/CMakeLists.txt" | cut -d ' ' -f2 | tr -d ')' | tr -d '\r\n')
+    mkdir -p "$PGO_DIR/bin"
+    cp "$PROJECT_ROOT/bin/Release/$project_name" "$PGO_DIR/bin/contexto-$name"
+}
+
+start_server() {
+    local binary=$1
+
+    # The daily targets of the synthetic workload are no secret
+    (cd "$PGO_DIR/run" && CONTEXTO_DAILY_SECRET_SEED=pgo-workload exec "$binary" --config "$PGO_DIR/run/static_config.yaml" > "$PGO_DIR/run/server.log" 2>&1) &
+    SERVER_PID=$!
+
+    # Loading the embeddings takes a while
+    for _ in $(seq 1 600); do
+        if curl -sf "http://127.0.0.1:$PORT/ping" > /dev/null; then
+            return
+        fi
+        if ! kill -0 "$SERVER_PID" 2>/dev/null; then
+            print_error "Server exited during startup, see $PGO_DIR/run/server.log"
+            exit 1
+        fi
+        sleep 0.5
+    done
+
+    print_error "Server did not become ready, see $PGO_DIR/run/server.log"
+    exit 1
+}
+
+# train <binary>: replays the training trace so the binary records its profile
+train() {
+    local binary=$1
+
+    print_info "Training $(basename "$binary")..."
+    start_server "$binary"
+    python3 "$WORKLOAD_TOOLS/replay.py" \
+        --trace "$PGO_DIR/workload/training_trace.txt" \
+        --port "$PORT" \
+        --workers "$BENCHMARK_WORKERS" \
+        --passes "$TRAINING_PASSES"
+    stop_server
+}
+
+# benchmark <name>: prints the throughput of bin/contexto-<name> on the benchmark trace
+benchmark() {
+    local name=$1
+    local binary="$PGO_DIR/bin/contexto-$name"
+
+    print_info "Benchmarking $name for ${BENCHMARK_DURATION}s..." >&2
+    start_server "$binary"
+
+    # A short warm-up fills caches and lets the session manager reach a steady state
+    python3 "$WORKLOAD_TOOLS/replay.py" --trace "$PGO_DIR/workload/benchmark_trace.txt" --port "$PORT" \
+        --workers "$BENCHMARK_WORKERS" --duration 3 > /dev/null
+    python3 "$WORKLOAD_TOOLS/replay.py" --trace "$PGO_DIR/workload/benchmark_trace.txt" --port "$PORT" \
+        --workers "$BENCHMARK_WORKERS" --duration "$BENCHMARK_DURATION" | tee "$PGO_DIR/$name.benchmark.log" >&2
+
+    stop_server
+    grep -m 1 "throughput_rps=" "$PGO_DIR/$name.benchmark.log" | cut -d '=' -f2
+}
+
+require_result() {
+    if [[ -z "$2" ]]; then
+        print_error "Benchmark of $1 failed, see $PGO_DIR/run/server.log"
+        exit 1
+    fi
+}
+
+merge_profiles() {
+    if [[ "$COMPILER" == "clang" ]]; then
+        print_info "Merging raw profiles..."
+        llvm-profdata merge --output="$PGO_DIR/profiles/contexto.profdata" "$PGO_DIR/profiles"/*.profraw
+    else
+        # GCC merges the counters of every run into the .gcda files when the process exits
+        print_info "Collected $(find "$PGO_DIR/profiles" -name '*.gcda' | wc -l) GCC profile files"
+    fi
+}
+
+bolt_optimize() {
+    local binary="$PGO_DIR/bin/contexto-pgo"
+    local profile="$PGO_DIR/profiles/bolt.fdata"
+
+    print_info "Instrumenting the PGO binary with llvm-bolt..."
+    rm -f "$profile"
+    llvm-bolt "$binary" -instrument --instrumentation-file="$profile" -o "$PGO_DIR/bin/contexto-bolt-instrumented"
+    train "$PGO_DIR/bin/contexto-bolt-instrumented"
+
+    print_info "Reordering the PGO binary with the BOLT profile..."
+    llvm-bolt "$binary" -o "$PGO_DIR/bin/contexto-pgo-bolt" -data="$profile" \
+        -reorder-blocks=ext-tsp -reorder-functions=hfsort -split-functions -split-all-cold -dyno-stats
+}
+
+report_delta() {
+    local name=$1
+    local baseline=$2
+    local optimized=$3
+
+    python3 -c "print(f'  $name: $optimized req/s ({($optimized / $baseline - 1) * 100:+.1f}% vs baseline)')"
+}
+
+main() {
+    print_info "Contexto PGO Build Script"
+    print_info "====================================="
+
+    parse_args "$@"
+    check_dependencies
+
+    mkdir -p "$PGO_DIR"
+    generate_workload
+    write_config
+
+    if [[ "$SKIP_BASELINE" -eq 0 ]]; then
+        build_stage baseline "-DPGO_MODE="
+    fi
+
+    # Stale counters from a previous source version would be merged into the new profile
+    rm -rf "$PGO_DIR/profiles"
+    mkdir -p "$PGO_DIR/profiles"
+
+    build_stage instrumented "-DPGO_MODE=generate"
+    train "$PGO_DIR/bin/contexto-instrumented"
+    merge_profiles
+
+    local optimized_args=("-DPGO_MODE=use")
+    if [[ "$ENABLE_BOLT" -eq 1 ]]; then
+        optimized_args+=("-DENABLE_BOLT=ON")
+    fi
+    build_stage pgo "${optimized_args[@]}"
+
+    if [[ "$ENABLE_BOLT" -eq 1 ]]; then
+        bolt_optimize
+    fi
+
+    print_success "PGO binary: $PGO_DIR/bin/contexto-pgo"
+
+    if [[ "$SKIP_BASELINE" -eq 1 ]]; then
+        return
+    fi
+
+    local baseline_rps=$(benchmark baseline)
+    require_result baseline "$baseline_rps"
+    local pgo_rps=$(benchmark pgo)
+    require_result pgo "$pgo_rps"
+
+    print_info "Throughput on the benchmark trace:"
+    echo "  baseline: $baseline_rps req/s"
+    report_delta "pgo" "$baseline_rps" "$pgo_rps"
+
+    if [[ "$ENABLE_BOLT" -eq 1 ]]; then
+        local bolt_rps=$(benchmark pgo-bolt)
+        require_result pgo-bolt "$bolt_rps"
+        report_delta "pgo+bolt" "$baseline_rps" "$bolt_rps"
+    fi
+}
+
+main "$@"
@@ -0,0 +1,86 @@
+#include "analytics_handler.hpp"
+#include "api_json.hpp"
+#include "guess_analytics.hpp"
+#include "word_dictionary_component.hpp"
+
+#include <userver/components/component_config.hpp>
+#include <userver/components/component_context.hpp>
+#include <userver/logging/log.hpp>
+#include <userver/server/http/http_status.hpp>
+#include <userver/yaml_config/merge_schemas.hpp>
+
+namespace contexto {
+
+namespace {
+
+std::optional<size_t> ParseSize(std::string_view arg) {
+  size_t value = 0;
+  const auto [end, error] = std::from_chars(arg.data(), arg.data() + arg.size(), value);
+  if (error != std::errc{} || end != arg.data() + arg.size()) return std::nullopt;
+  return value;
+}
+
+}  // namespace
+
+AnalyticsHandler::AnalyticsHandler(const userver::components::ComponentConfig& config,
+                                   const userver::components::ComponentContext& context)
+    : HttpHandlerBase(config, context, /*is_monitor=*/true),
+      analytics_(context.FindComponent<GuessAnalytics>()),
+      dictionary_(context.FindComponent<WordDictionaryComponent>()),
+      max_targets_(config["max-targets"].As<size_t>(20)) {
+  LOG_INFO() << "AnalyticsHandler initialized with max_targets=" << max_targets_;
+}
+
+std::string AnalyticsHandler::HandleRequestThrow(const userver::server::http::HttpRequest& request,
+                                                 userver::server::request::RequestContext&) const {
+  // Words are accepted in any spelling the guess endpoint accepts
+  const auto resolve = [&](const std::string& arg) -> std::optional<size_t> {
+    if (arg.empty()) return std::nullopt;
+    return dictionary_.GetDictionary().FindWordIndex(dictionary_.ResolveWord(arg));
+  };
+
+  const std::string& target_arg = request.GetArg("target");
+  const auto target_index = resolve(target_arg);
+  if (!target_arg.empty() && !target_index) {
+    request.SetResponseStatus(userver::server::http::HttpStatus::kNotFound);
+    return api::MakeError("Unknown target word");
+  }
+
+  const std::string& word_arg = request.GetArg("word");
+  const auto word_index = resolve(word_arg);
+  if (!word_arg.empty() && !word_index) {
+    request.SetResponseStatus(userver::server::http::HttpStatus::kNotFound);
+    return api::MakeError("Unknown guess word");
+  }
+
+  size_t targets_limit = max_targets_;
+  size_t top_guesses_limit = 10;
+  for (const auto& [name, limit] : {std::pair{"limit", &targets_limit}, std::pair{"top", &top_guesses_limit}}) {
+    const std::string& arg = request.GetArg(name);
+    if (arg.empty()) continue;
+
+    const auto value = ParseSize(arg);
+    if (!value) {
+      request.SetResponseStatus(userver::server::http::HttpStatus::kBadRequest);
+      return api::MakeError(std::string("Invalid ") + name);
+    }
+    *limit = std::min(*limit, *value);
+  }
+
+  return analytics_.MakeSnapshot(targets_limit, top_guesses_limit, target_index, word_index);
+}
+
+userver::yaml_config::Schema AnalyticsHandler::GetStaticConfigSchema() {
+  return userver::yaml_config::MergeSchemas<userver::server::handlers::HttpHandlerBase>(R"(
+type: object
+description: Guess analytics admin handler
+additionalProperties: false
+properties:
+  max-targets:
+    type: integer
+    description: maximum number of targets per response
+    defaultDescription: 20
+)");
+}
+
+}  // namespace contexto
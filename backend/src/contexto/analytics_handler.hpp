@@ -0,0 +1,29 @@
+#pragma once
+
+#include <userver/server/handlers/http_handler_base.hpp>
+
+namespace contexto {
+
+class GuessAnalytics;
+class WordDictionaryComponent;
+
+// Admin endpoint with a JSON snapshot of the guess analytics. It reveals target words, so it is served on the
+// monitor listener only, and being no game API handler it has no CORS.
+class AnalyticsHandler final : public userver::server::handlers::HttpHandlerBase {
+public:
+  static constexpr std::string_view kName = "contexto-analytics-handler";
+
+  AnalyticsHandler(const userver::components::ComponentConfig&, const userver::components::ComponentContext&);
+
+  std::string HandleRequestThrow(const userver::server::http::HttpRequest& request,
+                                 userver::server::request::RequestContext& context) const override;
+
+  static userver::yaml_config::Schema GetStaticConfigSchema();
+
+private:
+  const GuessAnalytics& analytics_;
+  const WordDictionaryComponent& dictionary_;
+  size_t max_targets_;
+};
+
+}  // namespace contexto
@@ -0,0 +1,194 @@
+#include "api_json.hpp"
+
+#include <userver/formats/json/parser/parser_state.hpp>
+#include <userver/formats/json/parser/typed_parser.hpp>
+#include <userver/formats/json/string_builder.hpp>
+
+namespace contexto::api {
+
+namespace {
+
+using userver::formats::json::StringBuilder;
+
+using userver::formats::json::parser::BaseParser;
+
+// Tracks the nesting depth so that nested values of other fields are skipped without being stored
+template <typename Result>
+class StringFieldsParser final : public userver::formats::json::parser::TypedParser<std::span<Result>> {
+public:
+  StringFieldsParser(std::span<const std::string_view> fields, std::span<Result> values)
+      : fields_(fields), values_(values) {}
+
+private:
+  void StartObject() override {
+    if (is_field_value_) this->BaseParser::StartObject();
+    ++depth_;
+  }
+
+  void EndObject() override {
+    if (--depth_ == 0) this->SetResult(std::span(values_));
+  }
+
+  void StartArray() override {
+    if (depth_ == 0 || is_field_value_) this->BaseParser::StartArray();
+    ++depth_;
+  }
+
+  void EndArray() override { --depth_; }
+
+  void Key(std::string_view key) override {
+    is_field_value_ = false;
+    if (depth_ != 1) return;
+
+    const auto it = std::find(fields_.begin(), fields_.end(), key);
+    is_field_value_ = it != fields_.end();
+    field_ = static_cast<size_t>(it - fields_.begin());
+  }
+
+  void String(std::string_view value) override {
+    if (depth_ == 0) this->BaseParser::String(value);
+    if (is_field_value_) {
+      values_[field_].assign(value);
+      is_field_value_ = false;
+    }
+  }
+
+  void Null() override { Scalar([this] { this->BaseParser::Null(); }); }
+  void Bool(bool value) override { Scalar([this, value] { this->BaseParser::Bool(value); }); }
+  void Int64(int64_t value) override { Scalar([this, value] { this->BaseParser::Int64(value); }); }
+  void Uint64(uint64_t value) override { Scalar([this, value] { this->BaseParser::Uint64(value); }); }
+  void Double(double value) override { Scalar([this, value] { this->BaseParser::Double(value); }); }
+
+  // Other scalars are fine anywhere except at the top level and as the value of the field
+  template <typename Reject>
+  void Scalar(Reject reject) {
+    if (depth_ == 0 || is_field_value_) reject();
+  }
+
+  std::string Expected() const override { return is_field_value_ ? "string" : "object"; }
+  std::string GetPathItem() const override {
+    return depth_ == 1 && is_field_value_ ? std::string(fields_[field_]) : "";
+  }
+
+  std::span<const std::string_view> fields_;
+  std::span<Result> values_;
+  size_t field_ = 0;  // Index of the field whose value comes next, when is_field_value_ is set
+  size_t depth_ = 0;
+  bool is_field_value_ = false;
+};
+
+template <typename Result>
+void ParseStringFieldsAs(std::string_view body, std::span<const std::string_view> fields, std::span<Result> values) {
+  StringFieldsParser<Result> parser(fields, values);
+  std::span<Result> result;
+  parser.Reset(result);
+
+  userver::formats::json::parser::ParserState state;
+  state.PushParser(parser);
+  state.ProcessInput(body);
+}
+
+}  // namespace
+
+std::string ParseStringField(std::string_view body, std::string_view field) {
+  std::string value;
+  ParseStringFieldsAs(body, std::span(&field, 1), std::span(&value, 1));
+  return value;
+}
+
+std::pmr::string ParseStringField(std::string_view body, std::string_view field, std::pmr::memory_resource& resource) {
+  std::pmr::string value(&resource);
+  ParseStringFieldsAs(body, std::span(&field, 1), std::span(&value, 1));
+  return value;
+}
+
+void ParseStringFields(std::string_view body, std::span<const std::string_view> fields,
+                       std::span<std::pmr::string> values) {
+  ParseStringFieldsAs(body, fields, values);
+}
+
+std::string MakeError(std::string_view message) {
+  StringBuilder builder;
+  {
+    const StringBuilder::ObjectGuard guard(builder);
+    builder.Key("error");
+    WriteToStream(message, builder);
+  }
+  return builder.GetString();
+}
+
+std::string MakeUnknownWordError(std::span<const std::string_view> suggestions) {
+  StringBuilder builder;
+  {
+    const StringBuilder::ObjectGuard guard(builder);
+    builder.Key("error");
+    WriteToStream(std::string_view("Invalid word"), builder);
+
+    if (!suggestions.empty()) {
+      builder.Key("suggestions");
+      const StringBuilder::ArrayGuard array_guard(builder);
+      for (const auto suggestion : suggestions) {
+        WriteToStream(suggestion, builder);
+      }
+    }
+  }
+  return builder.GetString();
+}
+
+std::string MakeNewGameResponse(std::string_view session_id, std::string_view puzzle_date,
+                                std::string_view difficulty) {
+  StringBuilder builder;
+  {
+    const StringBuilder::ObjectGuard guard(builder);
+    builder.Key("success");
+    WriteToStream(true, builder);
+    builder.Key("session_id");
+    WriteToStream(session_id, builder);
+    if (!puzzle_date.empty()) {
+      builder.Key("puzzle_date");
+      WriteToStream(puzzle_date, builder);
+    }
+    if (!difficulty.empty()) {
+      builder.Key("difficulty");
+      WriteToStream(difficulty, builder);
+    }
+  }
+  return builder.GetString();
+}
+
+std::string MakeGuessResponse(std::string_view word, int rank, std::string_view corrected_from, bool duplicate) {
+  StringBuilder builder;
+  {
+    const StringBuilder::ObjectGuard guard(builder);
+    builder.Key("word");
+    WriteToStream(word, builder);
+    builder.Key("rank");
+    WriteToStream(static_cast<int64_t>(rank), builder);
+    builder.Key("correct");
+    WriteToStream(std::string_view(rank == 1 ? "yes" : "no"), builder);
+
+    if (!corrected_from.empty()) {
+      builder.Key("corrected_from");
+      WriteToStream(corrected_from, builder);
+    }
+    if (duplicate) {
+      builder.Key("duplicate");
+      WriteToStream(true, builder);
+    }
+  }
+  return builder.GetString();
+}
+
+std::string MakeGiveUpResponse(std::string_view target_word) {
+  StringBuilder builder;
+  {
+    const StringBuilder::ObjectGuard guard(builder);
+    builder.Key("success");
+    WriteToStream(true, builder);
+    builder.Key("target_word");
+    WriteToStream(target_word, builder);
+  }
+  return builder.GetString();
+}
+
+}  // namespace contexto::api
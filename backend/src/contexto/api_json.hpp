@@ -0,0 +1,30 @@
+#pragma once
+
+#include <pch.hpp>
+
+// JSON bodies of the game API, read and written without building a formats::json::Value DOM
+namespace contexto::api {
+
+// Reads the top-level string field of a JSON object in one SAX pass, skipping every other field.
+// Returns an empty string if the field is absent, throws on malformed JSON or a non-string field.
+// The second overload allocates the result from the given resource, e.g. the arena of the request.
+std::string ParseStringField(std::string_view body, std::string_view field);
+std::pmr::string ParseStringField(std::string_view body, std::string_view field, std::pmr::memory_resource& resource);
+
+// Reads several top-level string fields in the same single pass, values[i] receives fields[i]. Values of absent
+// fields are left as they are.
+void ParseStringFields(std::string_view body, std::span<const std::string_view> fields,
+                       std::span<std::pmr::string> values);
+
+std::string MakeError(std::string_view message);
+std::string MakeUnknownWordError(std::span<const std::string_view> suggestions);
+
+// puzzle_date is set for daily games only
+std::string MakeNewGameResponse(std::string_view session_id, std::string_view puzzle_date = {},
+                                std::string_view difficulty = {});
+// duplicate marks a word the session had already guessed, the rank is the one it got then
+std::string MakeGuessResponse(std::string_view word, int rank, std::string_view corrected_from = {},
+                              bool duplicate = false);
+std::string MakeGiveUpResponse(std::string_view target_word);
+
+}  // namespace contexto::api
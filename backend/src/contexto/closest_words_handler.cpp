@@ -0,0 +1,107 @@
+#include "closest_words_handler.hpp"
+#include "api_json.hpp"
+#include "rank_table_cache.hpp"
+#include "session_manager.hpp"
+#include "word_dictionary_component.hpp"
+
+#include <userver/components/component_config.hpp>
+#include <userver/components/component_context.hpp>
+#include <userver/formats/json/string_builder.hpp>
+#include <userver/logging/log.hpp>
+#include <userver/server/http/http_status.hpp>
+#include <userver/yaml_config/merge_schemas.hpp>
+
+namespace contexto {
+
+ClosestWordsHandler::ClosestWordsHandler(const userver::components::ComponentConfig& config,
+                                         const userver::components::ComponentContext& context)
+    : CorsHandlerBase(config, context),
+      session_manager_(context.FindComponent<SessionManager>()),
+      dictionary_(context.FindComponent<WordDictionaryComponent>()),
+      rank_tables_(context.FindComponent<RankTableCache>()),
+      max_page_size_(config["max-page-size"].As<size_t>(100)) {
+  LOG_INFO() << "ClosestWordsHandler initialized with max_page_size=" << max_page_size_;
+}
+
+std::string ClosestWordsHandler::HandleApiRequest(const userver::server::http::HttpRequest& request,
+                                                  userver::server::request::RequestContext&,
+                                                  std::pmr::memory_resource&) const {
+  const auto& session_id = request.GetCookie("session_id");
+  if (session_id.empty() || !session_manager_.HasSession(session_id)) {
+    request.SetResponseStatus(userver::server::http::HttpStatus::kBadRequest);
+    return api::MakeError("Invalid game session");
+  }
+
+  // The list gives the answer away
+  if (!session_manager_.IsFinished(session_id)) {
+    request.SetResponseStatus(userver::server::http::HttpStatus::kForbidden);
+    return api::MakeError("Game is not over yet");
+  }
+
+  size_t offset = 0;
+  size_t limit = max_page_size_;
+  if (!ParseSizeArg(request.GetArg("offset"), offset) || !ParseSizeArg(request.GetArg("limit"), limit)) {
+    request.SetResponseStatus(userver::server::http::HttpStatus::kBadRequest);
+    return api::MakeError("Invalid offset or limit");
+  }
+  limit = std::min(limit, max_page_size_);
+
+  const auto& dictionary = dictionary_.GetDictionary();
+  const auto target_index = dictionary.FindWordIndex(session_manager_.GetTargetWord(session_id));
+  if (!target_index) {
+    request.SetResponseStatus(userver::server::http::HttpStatus::kInternalServerError);
+    LOG_ERROR() << "Target of session " << session_id << " has no embedding";
+    return api::MakeError("Failed to get closest words");
+  }
+
+  // Prepared games already hold their table, the others share the cached one of their target and build it at
+  // most once, on the compute task processor
+  auto ranks = session_manager_.GetRankTable(session_id);
+  if (!ranks) ranks = rank_tables_.Get(dictionary.GetWordWithEmbeddingByIndex(*target_index));
+  if (!ranks) {
+    request.SetResponseStatus(userver::server::http::HttpStatus::kInternalServerError);
+    return api::MakeError("Failed to get closest words");
+  }
+
+  const auto closest = ranks->GetClosestWords();
+  offset = std::min(offset, closest.size());
+  const auto page = closest.subspan(offset, std::min(limit, closest.size() - offset));
+
+  // Written straight into the response body, without building a JSON document first
+  userver::formats::json::StringBuilder builder;
+  {
+    const userver::formats::json::StringBuilder::ObjectGuard object_guard(builder);
+    builder.Key("target");
+    WriteToStream(dictionary.GetWord(*target_index), builder);
+    builder.Key("total");
+    WriteToStream(static_cast<uint64_t>(closest.size()), builder);
+    builder.Key("offset");
+    WriteToStream(static_cast<uint64_t>(offset), builder);
+    builder.Key("words");
+    const userver::formats::json::StringBuilder::ArrayGuard array_guard(builder);
+    for (const uint32_t index : page) {
+      const userver::formats::json::StringBuilder::ObjectGuard word_guard(builder);
+      builder.Key("word");
+      WriteToStream(dictionary.GetWord(index), builder);
+      builder.Key("rank");
+      WriteToStream(static_cast<int64_t>(ranks->GetRank(index, false).value_or(-1)), builder);
+    }
+  }
+
+  return builder.GetString();
+}
+
+userver::yaml_config::Schema ClosestWordsHandler::GetStaticConfigSchema() {
+  return userver::yaml_config::MergeSchemas<userver::server::handlers::HttpHandlerBase>(R"(
+type: object
+description: Handler revealing the words closest to the target of a finished game
+additionalProperties: false
+properties:
+  max-page-size:
+    type: integer
+    description: maximum number of words per page
+    defaultDescription: 100
+)");
+}
+
+}  // namespace contexto
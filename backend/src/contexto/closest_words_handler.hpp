@@ -0,0 +1,33 @@
+#pragma once
+
+#include "cors_handler_base.hpp"
+
+namespace contexto {
+
+class RankTableCache;
+class SessionManager;
+class WordDictionaryComponent;
+
+// Reveals the words closest to the target of a finished game: GET /api/closest-words?offset=&limit=.
+// Pages are slices of the neighbour list kept with the target's rank table, so a request never scans the vocabulary.
+class ClosestWordsHandler final : public CorsHandlerBase {
+public:
+  static constexpr std::string_view kName = "contexto-closest-words-handler";
+
+  ClosestWordsHandler(const userver::components::ComponentConfig&, const userver::components::ComponentContext&);
+
+  static userver::yaml_config::Schema GetStaticConfigSchema();
+
+protected:
+  std::string HandleApiRequest(const userver::server::http::HttpRequest&,
+                               userver::server::request::RequestContext&,
+                               std::pmr::memory_resource& arena) const override;
+
+private:
+  const SessionManager& session_manager_;
+  const WordDictionaryComponent& dictionary_;
+  const RankTableCache& rank_tables_;
+  size_t max_page_size_;
+};
+
+}  // namespace contexto
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <pch.hpp>
+
+#include <userver/cache/lru_map.hpp>
+#include <userver/engine/exception.hpp>
+#include <userver/engine/mutex.hpp>
+#include <userver/engine/task/shared_task_with_result.hpp>
+
+namespace contexto {
+
+// LRU cache whose misses are built by tasks. Concurrent requests for a key that is being built wait for the same
+// task instead of starting their own, so a burst on one key costs one build. A failed build is forgotten, and the
+// next request for its key starts a new one; a cancelled waiter leaves the build to the others.
+template <typename Key, typename Value>
+class CoalescingCache final {
+public:
+  using BuildTask = userver::engine::SharedTaskWithResult<Value>;
+
+  explicit CoalescingCache(size_t capacity) : values_(capacity) {}
+
+  // Cached value of the key, or the result of the build in flight for it, or of a new one started by
+  // start_build(). Waits for the build and rethrows its exception.
+  template <typename StartBuild>
+  Value Get(const Key& key, StartBuild start_build) {
+    InFlight build;
+    {
+      std::lock_guard lock(mutex_);
+      if (const auto* value = values_.Get(key)) {
+        hits_.fetch_add(1, std::memory_order_relaxed);
+        return *value;
+      }
+
+      const auto it = in_flight_.find(key);
+      if (it != in_flight_.end()) {
+        coalesced_.fetch_add(1, std::memory_order_relaxed);
+        build = it->second;
+      } else {
+        builds_.fetch_add(1, std::memory_order_relaxed);
+        build = InFlight{.task = start_build(), .id = ++last_build_id_};
+        in_flight_.emplace(key, build);
+      }
+    }
+
+    // Whoever sees the outcome first publishes it. The task itself never touches the maps, since dropping the
+    // last reference to a running task from inside it would wait for itself.
+    Value value;
+    try {
+      value = build.task.Get();
+    } catch (const userver::engine::WaitInterruptedException&) {
+      // Only this waiter was cancelled, e.g. by its deadline, the build goes on for everyone else
+      throw;
+    } catch (...) {
+      failures_.fetch_add(1, std::memory_order_relaxed);
+      {
+        std::lock_guard lock(mutex_);
+        Retire(key, build.id);
+      }
+      throw;
+    }
+
+    std::lock_guard lock(mutex_);
+    if (Retire(key, build.id)) values_.Put(key, value);
+    return value;
+  }
+
+  size_t Size() const {
+    std::lock_guard lock(mutex_);
+    return values_.GetSize();
+  }
+
+  size_t InFlightSize() const {
+    std::lock_guard lock(mutex_);
+    return in_flight_.size();
+  }
+
+  size_t Capacity() const {
+    std::lock_guard lock(mutex_);
+    return values_.GetCapacity();
+  }
+
+  size_t Hits() const noexcept { return hits_.load(std::memory_order_relaxed); }
+  size_t Builds() const noexcept { return builds_.load(std::memory_order_relaxed); }
+  size_t Coalesced() const noexcept { return coalesced_.load(std::memory_order_relaxed); }
+  size_t Failures() const noexcept { return failures_.load(std::memory_order_relaxed); }
+
+private:
+  struct InFlight {
+    BuildTask task;
+    uint64_t id = 0;  // Tells a build from a later one for the same key
+  };
+
+  // Removes the build from the in-flight map unless another caller already did. Returns whether it was there.
+  // Callers hold the mutex.
+  bool Retire(const Key& key, uint64_t id) {
+    const auto it = in_flight_.find(key);
+    if (it == in_flight_.end() || it->second.id != id) return false;
+    in_flight_.erase(it);
+    return true;
+  }
+
+  mutable userver::engine::Mutex mutex_;
+  userver::cache::LruMap<Key, Value> values_;
+  std::unordered_map<Key, InFlight> in_flight_;
+  uint64_t last_build_id_ = 0;
+
+  std::atomic<size_t> hits_ = 0;
+  std::atomic<size_t> builds_ = 0;
+  std::atomic<size_t> coalesced_ = 0;
+  std::atomic<size_t> failures_ = 0;
+};
+
+}  // namespace contexto
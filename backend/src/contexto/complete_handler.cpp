@@ -0,0 +1,76 @@
+#include "complete_handler.hpp"
+#include "api_json.hpp"
+#include "word_dictionary_component.hpp"
+
+#include <userver/components/component_config.hpp>
+#include <userver/components/component_context.hpp>
+#include <userver/formats/json/string_builder.hpp>
+#include <userver/logging/log.hpp>
+#include <userver/server/http/http_status.hpp>
+#include <userver/yaml_config/merge_schemas.hpp>
+
+namespace contexto {
+
+CompleteHandler::CompleteHandler(const userver::components::ComponentConfig& config,
+                                 const userver::components::ComponentContext& context)
+    : CorsHandlerBase(config, context),
+      dictionary_(context.FindComponent<WordDictionaryComponent>()),
+      max_completions_(std::min(config["max-completions"].As<size_t>(10), WordTrie::kMaxCompletions)) {
+  LOG_INFO() << "CompleteHandler initialized with max_completions=" << max_completions_;
+}
+
+std::string CompleteHandler::HandleApiRequest(const userver::server::http::HttpRequest& request,
+                                              userver::server::request::RequestContext&,
+                                              std::pmr::memory_resource&) const {
+  const std::string& prefix = request.GetArg("prefix");
+  if (!utils::utf8::IsValid(prefix)) {
+    request.SetResponseStatus(userver::server::http::HttpStatus::kBadRequest);
+    return api::MakeError("Invalid prefix encoding");
+  }
+
+  size_t limit = max_completions_;
+  const std::string& limit_arg = request.GetArg("limit");
+  if (!limit_arg.empty()) {
+    size_t requested_limit = 0;
+    const auto [end, error] = std::from_chars(limit_arg.data(), limit_arg.data() + limit_arg.size(), requested_limit);
+    if (error != std::errc{} || end != limit_arg.data() + limit_arg.size()) {
+      request.SetResponseStatus(userver::server::http::HttpStatus::kBadRequest);
+      return api::MakeError("Invalid limit");
+    }
+    limit = std::min(limit, requested_limit);
+  }
+
+  // An empty prefix would only list the most frequent words
+  std::array<std::string_view, WordTrie::kMaxCompletions> completions;
+  const size_t count = prefix.empty() ? 0 : dictionary_.CompleteWord(prefix, std::span(completions).first(limit));
+
+  // Written straight into the response body, without building a JSON document first
+  userver::formats::json::StringBuilder builder;
+  {
+    const userver::formats::json::StringBuilder::ObjectGuard object_guard(builder);
+    builder.Key("prefix");
+    WriteToStream(std::string_view(prefix), builder);
+    builder.Key("completions");
+    const userver::formats::json::StringBuilder::ArrayGuard array_guard(builder);
+    for (size_t i = 0; i < count; ++i) {
+      WriteToStream(completions[i], builder);
+    }
+  }
+
+  return builder.GetString();
+}
+
+userver::yaml_config::Schema CompleteHandler::GetStaticConfigSchema() {
+  return userver::yaml_config::MergeSchemas<userver::server::handlers::HttpHandlerBase>(R"(
+type: object
+description: Word prefix completion handler
+additionalProperties: false
+properties:
+  max-completions:
+    type: integer
+    description: maximum number of completions per request, capped at 32
+    defaultDescription: 10
+)");
+}
+
+}  // namespace contexto
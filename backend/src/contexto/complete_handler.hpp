@@ -0,0 +1,27 @@
+#pragma once
+
+#include "cors_handler_base.hpp"
+
+namespace contexto {
+
+class WordDictionaryComponent;
+
+class CompleteHandler final : public CorsHandlerBase {
+public:
+  static constexpr std::string_view kName = "contexto-complete-handler";
+
+  CompleteHandler(const userver::components::ComponentConfig&, const userver::components::ComponentContext&);
+
+  static userver::yaml_config::Schema GetStaticConfigSchema();
+
+protected:
+  std::string HandleApiRequest(const userver::server::http::HttpRequest&,
+                               userver::server::request::RequestContext&,
+                               std::pmr::memory_resource& arena) const override;
+
+private:
+  const WordDictionaryComponent& dictionary_;
+  size_t max_completions_;
+};
+
+}  // namespace contexto
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <pch.hpp>
+
+#include <userver/engine/sleep.hpp>
+
+namespace contexto {
+
+// Lets the other tasks of a task processor run during a long CPU-bound loop. Call Tick() once per iteration:
+// the clock is read every kCheckInterval iterations and the task yields once it has run for a whole slice.
+class CooperativeYield final {
+public:
+  static constexpr size_t kCheckInterval = 256;
+  static constexpr std::chrono::microseconds kDefaultSlice{500};
+
+  explicit CooperativeYield(std::chrono::microseconds slice = kDefaultSlice) noexcept
+      : slice_(slice), slice_start_(std::chrono::steady_clock::now()) {}
+
+  void Tick() {
+    if (++iterations_ % kCheckInterval != 0) return;
+
+    const auto now = std::chrono::steady_clock::now();
+    if (now - slice_start_ < slice_) return;
+
+    userver::engine::Yield();
+    slice_start_ = std::chrono::steady_clock::now();
+  }
+
+private:
+  std::chrono::microseconds slice_;
+  std::chrono::steady_clock::time_point slice_start_;
+  size_t iterations_ = 0;
+};
+
+}  // namespace contexto
@@ -0,0 +1,118 @@
+#include "cors_component.hpp"
+
+#include <userver/components/component_config.hpp>
+#include <userver/http/predefined_header.hpp>
+#include <userver/logging/log.hpp>
+#include <userver/server/http/http_response.hpp>
+#include <userver/yaml_config/merge_schemas.hpp>
+
+namespace contexto {
+
+namespace {
+
+constexpr userver::http::headers::PredefinedHeader kAllowOrigin("Access-Control-Allow-Origin");
+constexpr userver::http::headers::PredefinedHeader kAllowMethods("Access-Control-Allow-Methods");
+constexpr userver::http::headers::PredefinedHeader kAllowHeaders("Access-Control-Allow-Headers");
+constexpr userver::http::headers::PredefinedHeader kAllowCredentials("Access-Control-Allow-Credentials");
+constexpr userver::http::headers::PredefinedHeader kMaxAge("Access-Control-Max-Age");
+constexpr userver::http::headers::PredefinedHeader kVary("Vary");
+
+std::string JoinValues(const std::vector<std::string>& values) {
+  std::string joined;
+  for (const auto& value : values) {
+    if (!joined.empty()) joined += ", ";
+    joined += value;
+  }
+  return joined;
+}
+
+}  // namespace
+
+CorsComponent::CorsComponent(const userver::components::ComponentConfig& config,
+                             const userver::components::ComponentContext& context)
+    : LoggableComponentBase(config, context),
+      allow_credentials_(config["allow-credentials"].As<bool>(true)),
+      allowed_methods_(JoinValues(
+          config["allowed-methods"].As<std::vector<std::string>>(std::vector<std::string>{"GET", "POST", "OPTIONS"}))),
+      allowed_headers_(JoinValues(config["allowed-headers"].As<std::vector<std::string>>(
+          std::vector<std::string>{"Content-Type", "X-Requested-With"}))),
+      max_age_(std::to_string(config["max-age"].As<int64_t>(600))) {
+  for (auto& origin : config["allowed-origins"].As<std::vector<std::string>>(std::vector<std::string>{})) {
+    if (origin == "*") {
+      allow_any_origin_ = true;
+      continue;
+    }
+    allowed_origins_.insert(std::move(origin));
+  }
+
+  if (allow_any_origin_) {
+    LOG_WARNING() << "CORS allows any origin";
+  }
+
+  LOG_INFO() << "CorsComponent initialized with " << allowed_origins_.size()
+             << " allowed origins, allow_credentials=" << allow_credentials_;
+}
+
+bool CorsComponent::ApplyHeaders(const userver::server::http::HttpRequest& request) const {
+  const std::string& origin = request.GetHeader("Origin");
+
+  // Same-origin and non-browser requests don't need CORS headers
+  if (origin.empty()) return true;
+  if (!IsAllowedOrigin(origin)) return false;
+
+  auto& response = request.GetHttpResponse();
+
+  // The origin is echoed back rather than '*', which browsers reject for credentialed requests
+  response.SetHeader(kAllowOrigin, origin);
+  response.SetHeader(kVary, "Origin");
+  response.SetHeader(kAllowMethods, allowed_methods_);
+  response.SetHeader(kAllowHeaders, allowed_headers_);
+  if (allow_credentials_) {
+    response.SetHeader(kAllowCredentials, "true");
+  }
+  if (request.GetMethod() == userver::server::http::HttpMethod::kOptions) {
+    response.SetHeader(kMaxAge, max_age_);
+  }
+
+  return true;
+}
+
+userver::yaml_config::Schema CorsComponent::GetStaticConfigSchema() {
+  return userver::yaml_config::MergeSchemas<userver::components::LoggableComponentBase>(R"(
+type: object
+description: CORS policy shared by the API handlers
+additionalProperties: false
+properties:
+  allowed-origins:
+    type: array
+    description: origins allowed to call the API, '*' allows any origin
+    items:
+      type: string
+      description: origin, e.g. http://localhost:3000
+    defaultDescription: "[]"
+  allowed-methods:
+    type: array
+    description: methods announced in preflight responses
+    items:
+      type: string
+      description: HTTP method
+    defaultDescription: "[GET, POST, OPTIONS]"
+  allowed-headers:
+    type: array
+    description: request headers announced in preflight responses
+    items:
+      type: string
+      description: header name
+    defaultDescription: "[Content-Type, X-Requested-With]"
+  allow-credentials:
+    type: boolean
+    description: whether the browser may send cookies with cross-origin requests
+    defaultDescription: true
+  max-age:
+    type: integer
+    description: seconds the browser may cache a preflight response
+    defaultDescription: 600
+)");
+}
+
+}  // namespace contexto
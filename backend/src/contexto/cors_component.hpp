@@ -0,0 +1,44 @@
+#pragma once
+
+#include <pch.hpp>
+
+#include <userver/components/loggable_component_base.hpp>
+#include <userver/server/http/http_request.hpp>
+#include <userver/yaml_config/schema.hpp>
+
+namespace contexto {
+
+// CORS policy of the API. Header values are built once from the static config, so applying the policy
+// to a request is an origin lookup plus a few header copies.
+class CorsComponent final : public userver::components::LoggableComponentBase {
+public:
+  static constexpr std::string_view kName = "cors";
+
+  CorsComponent(const userver::components::ComponentConfig& config,
+                const userver::components::ComponentContext& context);
+
+  // Adds the CORS headers for the request origin; returns false if the origin isn't allowed
+  bool ApplyHeaders(const userver::server::http::HttpRequest& request) const;
+
+  static userver::yaml_config::Schema GetStaticConfigSchema();
+
+private:
+  struct StringHash {
+    using is_transparent = void;
+    size_t operator()(std::string_view str) const noexcept { return std::hash<std::string_view>{}(str); }
+  };
+
+  bool IsAllowedOrigin(std::string_view origin) const {
+    return allow_any_origin_ || allowed_origins_.contains(origin);
+  }
+
+  std::unordered_set<std::string, StringHash, std::equal_to<>> allowed_origins_;
+  bool allow_any_origin_ = false;
+  bool allow_credentials_ = true;
+
+  std::string allowed_methods_;
+  std::string allowed_headers_;
+  std::string max_age_;
+};
+
+}  // namespace contexto
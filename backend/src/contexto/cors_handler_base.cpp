@@ -0,0 +1,49 @@
+#include "cors_handler_base.hpp"
+#include "api_json.hpp"
+#include "cors_component.hpp"
+
+#include <userver/components/component_config.hpp>
+#include <userver/components/component_context.hpp>
+#include <userver/components/statistics_storage.hpp>
+#include <userver/server/http/http_status.hpp>
+#include <userver/utils/scope_guard.hpp>
+#include <userver/utils/statistics/labels.hpp>
+#include <userver/utils/statistics/writer.hpp>
+
+namespace contexto {
+
+CorsHandlerBase::CorsHandlerBase(const userver::components::ComponentConfig& config,
+                                 const userver::components::ComponentContext& context)
+    : HttpHandlerBase(config, context), cors_(context.FindComponent<CorsComponent>()) {
+  arena_statistics_holder_ =
+      context.FindComponent<userver::components::StatisticsStorage>().GetStorage().RegisterWriter(
+          "contexto.arena",
+          [this](userver::utils::statistics::Writer& writer) { arena_counters_.Write(writer); },
+          {userver::utils::statistics::Label("handler", config.Name())});
+}
+
+CorsHandlerBase::~CorsHandlerBase() { arena_statistics_holder_.Unregister(); }
+
+std::string CorsHandlerBase::HandleRequestThrow(const userver::server::http::HttpRequest& request,
+                                                userver::server::request::RequestContext& context) const {
+  const bool is_allowed_origin = cors_.ApplyHeaders(request);
+
+  if (request.GetMethod() == userver::server::http::HttpMethod::kOptions) {
+    request.SetResponseStatus(is_allowed_origin ? userver::server::http::HttpStatus::kNoContent
+                                                : userver::server::http::HttpStatus::kForbidden);
+    return "";
+  }
+
+  // Browsers drop responses to disallowed origins anyway, so the request is refused up front
+  if (!is_allowed_origin) {
+    request.SetResponseStatus(userver::server::http::HttpStatus::kForbidden);
+    return api::MakeError("Origin is not allowed");
+  }
+
+  // Accounted on the way out, so that requests that throw are counted too
+  utils::RequestArena arena;
+  const userver::utils::ScopeGuard account([&] { arena_counters_.Account(arena); });
+  return HandleApiRequest(request, context, arena);
+}
+
+}  // namespace contexto
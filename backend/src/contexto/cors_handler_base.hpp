@@ -0,0 +1,43 @@
+#pragma once
+
+#include <userver/server/handlers/http_handler_base.hpp>
+#include <userver/utils/statistics/entry.hpp>
+
+#include "statistics.hpp"
+
+namespace contexto {
+
+class CorsComponent;
+
+// Base of the API handlers: applies the CORS policy and answers preflight requests before the
+// handler body runs. Every request gets its own arena for temporaries, released when the response is ready;
+// arena usage is exported as contexto.arena with a handler label.
+class CorsHandlerBase : public userver::server::handlers::HttpHandlerBase {
+public:
+  CorsHandlerBase(const userver::components::ComponentConfig& config,
+                  const userver::components::ComponentContext& context);
+  ~CorsHandlerBase() override;
+
+  std::string HandleRequestThrow(const userver::server::http::HttpRequest& request,
+                                 userver::server::request::RequestContext& context) const final;
+
+protected:
+  // The response itself is handed to the server and must not live in the arena
+  virtual std::string HandleApiRequest(const userver::server::http::HttpRequest& request,
+                                       userver::server::request::RequestContext& context,
+                                       std::pmr::memory_resource& arena) const = 0;
+
+  // Parses a non-negative integer query argument, an absent argument leaves value unchanged
+  static bool ParseSizeArg(const std::string& arg, size_t& value) {
+    if (arg.empty()) return true;
+    const auto [end, error] = std::from_chars(arg.data(), arg.data() + arg.size(), value);
+    return error == std::errc{} && end == arg.data() + arg.size();
+  }
+
+private:
+  const CorsComponent& cors_;
+  mutable statistics::ArenaCounters arena_counters_;
+  userver::utils::statistics::Entry arena_statistics_holder_;
+};
+
+}  // namespace contexto
@@ -0,0 +1,178 @@
+#include "daily_puzzle_component.hpp"
+#include "rank_table_cache.hpp"
+#include "word_dictionary_component.hpp"
+
+#include <utils/fnv1a.hpp>
+
+#include <fmt/format.h>
+
+#include <userver/components/component_config.hpp>
+#include <userver/components/component_context.hpp>
+#include <userver/components/statistics_storage.hpp>
+#include <userver/logging/log.hpp>
+#include <userver/utils/statistics/writer.hpp>
+#include <userver/yaml_config/merge_schemas.hpp>
+
+namespace contexto {
+
+namespace {
+
+// There is deliberately no default: a seed that anyone can read gives away every daily target
+std::string RequireSeed(std::string seed) {
+  if (seed.empty()) {
+    throw std::runtime_error(
+        "daily-puzzle needs a secret-seed, e.g. from the CONTEXTO_DAILY_SECRET_SEED environment variable");
+  }
+  return seed;
+}
+
+std::chrono::sys_days CurrentDay() { return std::chrono::floor<std::chrono::days>(std::chrono::system_clock::now()); }
+
+}  // namespace
+
+DailyPuzzleComponent::DailyPuzzleComponent(const userver::components::ComponentConfig& config,
+                                           const userver::components::ComponentContext& context)
+    : LoggableComponentBase(config, context),
+      dictionary_(context.FindComponent<WordDictionaryComponent>()),
+      rank_tables_(context.FindComponent<RankTableCache>()),
+      seed_hash_(utils::Fnv1a(RequireSeed(config["secret-seed"].As<std::string>({})))),
+      prepare_ahead_(config["prepare-ahead"].As<std::chrono::seconds>(std::chrono::hours{1})) {
+  const auto refresh_interval = config["refresh-interval"].As<std::chrono::milliseconds>(std::chrono::minutes{1});
+
+  // Today's puzzle is needed before the first request
+  Refresh();
+
+  refresh_task_.Start("daily-puzzle-refresh", {refresh_interval}, [this] { Refresh(); });
+
+  statistics_holder_ =
+      context.FindComponent<userver::components::StatisticsStorage>().GetStorage().RegisterWriter(
+          "contexto.daily", [this](userver::utils::statistics::Writer& writer) { WriteStatistics(writer); });
+
+  LOG_INFO() << "DailyPuzzleComponent initialized with prepare_ahead=" << prepare_ahead_.count()
+             << "s, refresh_interval=" << refresh_interval.count() << "ms";
+}
+
+DailyPuzzleComponent::~DailyPuzzleComponent() {
+  statistics_holder_.Unregister();
+  refresh_task_.Stop();
+}
+
+std::shared_ptr<const DailyPuzzle> DailyPuzzleComponent::GetToday() const {
+  const auto today = CurrentDay();
+  {
+    std::shared_lock lock(mutex_);
+    if (tomorrow_ && tomorrow_->date == today) return tomorrow_;
+    if (today_ && today_->date == today) return today_;
+  }
+
+  // Concurrent callers share one table build through the cache
+  auto puzzle = BuildPuzzle(today);
+  if (!puzzle) return nullptr;
+
+  std::lock_guard lock(mutex_);
+  if (!today_ || today_->date != today) today_ = puzzle;
+  return today_;
+}
+
+void DailyPuzzleComponent::Refresh() {
+  const auto now = std::chrono::system_clock::now();
+  const auto today = std::chrono::floor<std::chrono::days>(now);
+  const auto tomorrow = today + std::chrono::days{1};
+
+  bool need_today = false;
+  bool need_tomorrow = false;
+  {
+    std::lock_guard lock(mutex_);
+    if (tomorrow_ && tomorrow_->date == today) {
+      today_ = std::move(tomorrow_);
+      tomorrow_.reset();
+      LOG_INFO() << "Daily puzzle rolled over to " << today_->date_string;
+    }
+
+    need_today = !today_ || today_->date != today;
+    need_tomorrow = tomorrow - now <= prepare_ahead_ && (!tomorrow_ || tomorrow_->date != tomorrow);
+  }
+
+  // Tables are built outside the lock, guesses keep reading the current ones meanwhile. A GetToday() racing
+  // with this build waits for the same cached table.
+  if (need_today) {
+    auto puzzle = BuildPuzzle(today);
+    std::lock_guard lock(mutex_);
+    today_ = std::move(puzzle);
+  }
+
+  if (need_tomorrow) {
+    auto puzzle = BuildPuzzle(tomorrow);
+    std::lock_guard lock(mutex_);
+    tomorrow_ = std::move(puzzle);
+  }
+}
+
+std::shared_ptr<const DailyPuzzle> DailyPuzzleComponent::BuildPuzzle(std::chrono::sys_days date) const {
+  const models::DictionaryWord* target = dictionary_.SelectTargetWord(TargetKey(date));
+  if (!target) {
+    LOG_ERROR() << "Failed to select the daily target word";
+    return nullptr;
+  }
+
+  const std::chrono::year_month_day ymd(date);
+  auto date_string = fmt::format("{:04}-{:02}-{:02}", static_cast<int>(ymd.year()),
+                                 static_cast<unsigned>(ymd.month()), static_cast<unsigned>(ymd.day()));
+
+  const auto build_start = std::chrono::steady_clock::now();
+  auto ranks = rank_tables_.Get(*target);
+  if (!ranks) return nullptr;
+  auto puzzle = std::make_shared<const DailyPuzzle>(date, std::move(date_string), std::move(ranks));
+  const auto build_duration =
+      std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - build_start);
+
+  tables_built_.fetch_add(1, std::memory_order_relaxed);
+  last_build_duration_ms_.store(build_duration.count(), std::memory_order_relaxed);
+
+  // The target itself stays out of the logs, anyone with log access could spoil the day
+  LOG_INFO() << "Built daily rank table for " << puzzle->date_string << " in " << build_duration.count() << "ms, "
+             << puzzle->ranks->MemoryUsage() << " bytes";
+  return puzzle;
+}
+
+uint64_t DailyPuzzleComponent::TargetKey(std::chrono::sys_days date) const noexcept {
+  return utils::SplitMix64(seed_hash_ ^ static_cast<uint64_t>(date.time_since_epoch().count()));
+}
+
+void DailyPuzzleComponent::WriteStatistics(userver::utils::statistics::Writer& writer) const {
+  bool today_ready = false;
+  bool tomorrow_ready = false;
+  {
+    const auto today = CurrentDay();
+    std::shared_lock lock(mutex_);
+    today_ready = (today_ && today_->date == today) || (tomorrow_ && tomorrow_->date == today);
+    tomorrow_ready = tomorrow_ && tomorrow_->date == today + std::chrono::days{1};
+  }
+
+  writer["today-ready"] = today_ready ? 1 : 0;
+  writer["tomorrow-ready"] = tomorrow_ready ? 1 : 0;
+  writer["tables-built"] = tables_built_.load(std::memory_order_relaxed);
+  writer["last-build-duration-ms"] = last_build_duration_ms_.load(std::memory_order_relaxed);
+}
+
+userver::yaml_config::Schema DailyPuzzleComponent::GetStaticConfigSchema() {
+  return userver::yaml_config::MergeSchemas<userver::components::LoggableComponentBase>(R"(
+type: object
+description: Daily shared puzzle component
+additionalProperties: false
+properties:
+  secret-seed:
+    type: string
+    description: secret the daily targets are derived from, the same on all replicas; required, never commit it
+  prepare-ahead:
+    type: string
+    description: how long before midnight UTC the next day's rank table is built
+    defaultDescription: 1h
+  refresh-interval:
+    type: string
+    description: how often the background task checks whether a rank table has to be built
+    defaultDescription: 1m
+)");
+}
+
+}  // namespace contexto
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "rank_table.hpp"
+
+#include <userver/components/loggable_component_base.hpp>
+#include <userver/engine/shared_mutex.hpp>
+#include <userver/utils/periodic_task.hpp>
+#include <userver/utils/statistics/entry.hpp>
+
+namespace contexto {
+
+class RankTableCache;
+class WordDictionaryComponent;
+
+struct DailyPuzzle {
+  std::chrono::sys_days date;
+  std::string date_string;  // YYYY-MM-DD
+  std::shared_ptr<const RankTable> ranks;
+};
+
+// Word of the day shared by all players. The target is derived from the UTC date and a secret seed, so every
+// replica picks the same one, and its rank table is built on a background task before the day starts.
+class DailyPuzzleComponent final : public userver::components::LoggableComponentBase {
+public:
+  static constexpr std::string_view kName = "daily-puzzle";
+
+  DailyPuzzleComponent(const userver::components::ComponentConfig& config,
+                       const userver::components::ComponentContext& context);
+  ~DailyPuzzleComponent() override;
+
+  // Puzzle of the current UTC day, nullptr if its table couldn't be built. If the background task hasn't
+  // prepared it yet, e.g. right after startup or a missed refresh, the first callers build it and wait.
+  std::shared_ptr<const DailyPuzzle> GetToday() const;
+
+  static userver::yaml_config::Schema GetStaticConfigSchema();
+
+private:
+  void Refresh();
+  std::shared_ptr<const DailyPuzzle> BuildPuzzle(std::chrono::sys_days date) const;
+  uint64_t TargetKey(std::chrono::sys_days date) const noexcept;
+
+  void WriteStatistics(userver::utils::statistics::Writer& writer) const;
+
+  const WordDictionaryComponent& dictionary_;
+  const RankTableCache& rank_tables_;
+  uint64_t seed_hash_ = 0;
+  std::chrono::seconds prepare_ahead_{0};
+
+  // Tomorrow's table is built ahead of time and takes over at midnight, even before the next refresh
+  mutable userver::engine::SharedMutex mutex_;
+  mutable std::shared_ptr<const DailyPuzzle> today_;
+  std::shared_ptr<const DailyPuzzle> tomorrow_;
+
+  mutable std::atomic<size_t> tables_built_ = 0;
+  mutable std::atomic<int64_t> last_build_duration_ms_ = 0;
+  userver::utils::PeriodicTask refresh_task_;
+  userver::utils::statistics::Entry statistics_holder_;
+};
+
+}  // namespace contexto
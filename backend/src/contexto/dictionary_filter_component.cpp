@@ -58,7 +58,8 @@ DictionaryFilterComponent::DictionaryFilterComponent(const userver::components::
     LOG_INFO() << "No valid embedding word types specified, defaulting to: any";
   }
 
-  // Load dictionary preferred types
+  // Load dictionary preferred types, with their names as keys of target-sampling
+  std::vector<std::string> dictionary_type_names;
   if (config.HasMember("dictionary-preferred-types")) {
     const auto& word_types = config["dictionary-preferred-types"].As<std::vector<std::string>>();
     for (const auto& type_str : word_types) {
@@ -72,12 +73,14 @@ DictionaryFilterComponent::DictionaryFilterComponent(const userver::components::
       if (word_type == models::WordType::kAny) {
         dictionary_preferred_types_.clear();
         dictionary_preferred_types_.push_back(models::WordType::kAny);
+        dictionary_type_names = {type_str};
         LOG_INFO() << "Setting dictionary preferred type to: any (accepting all types)";
         break;
       }
 
       if (std::ranges::find(dictionary_preferred_types_, word_type) == dictionary_preferred_types_.end()) {
         dictionary_preferred_types_.push_back(word_type);
+        dictionary_type_names.push_back(type_str);
         LOG_INFO() << "Adding dictionary preferred type: " << type_str;
       }
     }
@@ -86,9 +89,33 @@ DictionaryFilterComponent::DictionaryFilterComponent(const userver::components::
   // If no valid dictionary types were specified, default to any
   if (dictionary_preferred_types_.empty()) {
     dictionary_preferred_types_.push_back(models::WordType::kAny);
+    dictionary_type_names = {"any"};
     LOG_INFO() << "No valid dictionary word types specified, defaulting to: any";
   }
 
+  // Types without an entry in target-sampling are drawn uniformly
+  const auto target_sampling = config["target-sampling"];
+  for (size_t i = 0; i < dictionary_preferred_types_.size(); ++i) {
+    const auto type_sampling = target_sampling[dictionary_type_names[i]];
+    const auto distribution = type_sampling["distribution"].As<std::string>("uniform");
+    if (distribution != "uniform" && distribution != "frequency") {
+      throw std::runtime_error("Unknown target distribution '" + distribution + "' for '" +
+                               dictionary_type_names[i] + "'");
+    }
+
+    target_sampling_.push_back(TargetSampling{
+        .type = dictionary_preferred_types_[i],
+        .distribution = distribution == "frequency" ? TargetDistribution::kFrequency : TargetDistribution::kUniform,
+        .frequency_exponent = type_sampling["frequency-exponent"].As<double>(1.0),
+        .weight = type_sampling["weight"].As<double>(1.0),
+    });
+    LOG_INFO() << "Targets of type '" << dictionary_type_names[i] << "' are drawn with " << distribution
+               << " distribution, weight=" << target_sampling_.back().weight;
+  }
+
+  embedding_type_filter_ = CompileTypeFilter(embedding_preferred_types_);
+  dictionary_type_filter_ = CompileTypeFilter(dictionary_preferred_types_);
+
   LOG_INFO() << "Dictionary filter initialized with " << embedding_preferred_types_.size()
              << " embedding preferred types, " << dictionary_preferred_types_.size()
              << " dictionary preferred types, min_length=" << min_word_length_
@@ -123,7 +150,7 @@ bool DictionaryFilterComponent::LoadBlacklistedWords(std::string_view file_path)
       line.resize(pos_separator + 1);
     }
 
-    line = utils::utf8::ToLower(line);
+    utils::utf8::ToLowerInPlace(line);
     blacklisted_words_.insert(std::move(line));
   }
 
@@ -132,84 +159,36 @@ bool DictionaryFilterComponent::LoadBlacklistedWords(std::string_view file_path)
   return true;
 }
 
-bool DictionaryFilterComponent::FilterByWordType(std::string_view word,
-                                                 const std::vector<models::WordType>& preferred_types) const {
-  // Check if "any" type is allowed
-  for (const auto& type : preferred_types) {
-    if (type == models::WordType::kAny) return false;  // Don't filter if any type is allowed
-  }
-
-  if (!models::WordHasPOS(word)) {
-    // Word without POS and we're filtering by type
-    return true;  // Filter out
+DictionaryFilterComponent::TypeFilter DictionaryFilterComponent::CompileTypeFilter(
+    std::span<const models::WordType> preferred_types) noexcept {
+  TypeFilter type_filter;
+  for (const auto type : preferred_types) {
+    if (type == models::WordType::kAny) type_filter.accepts_any = true;
+    type_filter.allowed_types |= models::WordTypeBit(type);
   }
+  return type_filter;
+}
 
-  // Check word type against preferred types
-  const size_t pos_separator = word.find_last_of('_');
-  if (pos_separator != std::string::npos) {
-    const std::string_view pos_tag_view(word.data() + pos_separator + 1, word.size() - pos_separator - 1);
-    const models::WordType word_type = models::GetWordTypeFromPOS(pos_tag_view);
+bool DictionaryFilterComponent::ShouldFilterOut(std::string_view word, const TypeFilter& type_filter) const {
+  const models::ParsedWord parsed = models::ParseWordWithPOS(word);
 
-    // Check if this word type is in preferred types
-    for (const auto& type : preferred_types) {
-      if (type == word_type) return false;  // Don't filter if it matches a preferred type
-    }
+  // Words without POS are filtered out when we care about types
+  if (!type_filter.accepts_any &&
+      (!parsed.has_pos || (type_filter.allowed_types & models::WordTypeBit(parsed.type)) == 0)) {
+    return true;
   }
 
-  return true;  // Filter out if no match found
+  if (parsed.char_count < min_word_length_) return true;
+
+  return IsBlacklisted(parsed.word);
 }
 
 bool DictionaryFilterComponent::ShouldFilterOutEmbedding(std::string_view word) const {
-  if (models::WordHasPOS(word)) {
-    const std::string_view word_part = models::GetWordFromWordWithPOS(word);
-
-    if (utils::utf8::CharCount(word_part) < min_word_length_) {
-      return true;
-    }
-
-    if (IsBlacklisted(std::string(word_part))) return true;
-
-    return FilterByWordType(word, embedding_preferred_types_);
-  } else {
-    // Word without POS
-    if (utils::utf8::CharCount(word) < min_word_length_) {
-      return true;
-    }
-
-    if (IsBlacklisted(std::string(word))) return true;
-
-    // If we're strict about types and types are specified, filter words without POS
-    const bool result = std::ranges::all_of(embedding_preferred_types_,
-                                            [](models::WordType type) { return type != models::WordType::kAny; });
-    return result;  // Filter out words without POS when we care about types
-  }
+  return ShouldFilterOut(word, embedding_type_filter_);
 }
 
 bool DictionaryFilterComponent::ShouldFilterOutDictionary(std::string_view word) const {
-  if (models::WordHasPOS(word)) {
-    const std::string_view word_part = models::GetWordFromWordWithPOS(word);
-
-    if (utils::utf8::CharCount(word_part) < min_word_length_) {
-      return true;
-    }
-
-    if (IsBlacklisted(std::string(word_part))) return true;
-
-    return FilterByWordType(word, dictionary_preferred_types_);
-  } else {
-    // Word without POS
-    if (utils::utf8::CharCount(word) < min_word_length_) {
-      return true;
-    }
-
-    if (IsBlacklisted(std::string(word))) return true;
-
-    // If we're strict about types and types are specified, filter words without POS
-    const bool result = std::ranges::all_of(embedding_preferred_types_,
-                                            [](models::WordType type) { return type != models::WordType::kAny; });
-
-    return result;  // Filter out words without POS when we care about types
-  }
+  return ShouldFilterOut(word, dictionary_type_filter_);
 }
 
 models::WordType DictionaryFilterComponent::StringToWordType(std::string_view str) noexcept {
@@ -260,6 +239,27 @@ properties:
     type: integer
     description: Minimum length of words to include in the dictionary
     defaultDescription: 2
+  target-sampling:
+    type: object
+    description: How targets are drawn, keyed by the names listed in dictionary-preferred-types
+    properties: {}
+    additionalProperties:
+      type: object
+      description: Sampling of one preferred type
+      additionalProperties: false
+      properties:
+        distribution:
+          type: string
+          description: uniform, or frequency to favour words that are common in the corpus
+          defaultDescription: uniform
+        frequency-exponent:
+          type: number
+          description: exponent s of the frequency distribution, a word of frequency rank r has weight 1 / r^s
+          defaultDescription: 1.0
+        weight:
+          type: number
+          description: relative share of new games with a target of this type
+          defaultDescription: 1.0
 )");
 }
 
@@ -7,6 +7,19 @@
 
 namespace contexto {
 
+enum class TargetDistribution {
+  kUniform,
+  kFrequency,  // Zipf-like over the corpus frequency rank, common words become targets more often
+};
+
+// How targets of one preferred dictionary type are drawn
+struct TargetSampling {
+  models::WordType type = models::WordType::kAny;
+  TargetDistribution distribution = TargetDistribution::kUniform;
+  double frequency_exponent = 1.0;
+  double weight = 1.0;  // Share of new games with a target of this type, relative to the other preferred types
+};
+
 class DictionaryFilterComponent final : public userver::components::LoggableComponentBase {
 public:
   static constexpr std::string_view kName = "dictionary-filter";
@@ -25,14 +38,12 @@ public:
     return ShouldFilterOutDictionary(dict_word.word_with_pos);
   }
 
-  bool IsBlacklisted(const std::string& word) const {
+  bool IsBlacklisted(std::string_view word) const {
     if (blacklisted_words_.empty()) return false;
     return blacklisted_words_.contains(word);
   }
 
-  bool IsBlacklisted(const models::DictionaryWord& dict_word) const {
-    return IsBlacklisted(std::string(dict_word.GetWord()));
-  }
+  bool IsBlacklisted(const models::DictionaryWord& dict_word) const { return IsBlacklisted(dict_word.GetWord()); }
 
   bool HasPreferredEmbeddingType(models::WordType word_type) const {
     if (embedding_preferred_types_.empty()) return false;
@@ -54,17 +65,35 @@ public:
   std::span<const models::WordType> GetEmbeddingPreferredTypes() const noexcept { return embedding_preferred_types_; }
   std::span<const models::WordType> GetDictionaryPreferredTypes() const noexcept { return dictionary_preferred_types_; }
 
+  // One entry per dictionary preferred type, in the same order
+  std::span<const TargetSampling> GetTargetSampling() const noexcept { return target_sampling_; }
+
   static userver::yaml_config::Schema GetStaticConfigSchema();
 
 private:
+  // Preferred types compiled into a bitmask of models::WordTypeBit
+  struct TypeFilter {
+    uint32_t allowed_types = 0;
+    bool accepts_any = false;
+  };
+
+  struct StringHash {
+    using is_transparent = void;
+    size_t operator()(std::string_view str) const noexcept { return std::hash<std::string_view>{}(str); }
+  };
+
   static models::WordType StringToWordType(std::string_view str) noexcept;
+  static TypeFilter CompileTypeFilter(std::span<const models::WordType> preferred_types) noexcept;
   bool LoadBlacklistedWords(std::string_view file_path);
-  bool FilterByWordType(std::string_view word, const std::vector<models::WordType>& preferred_types) const;
+  bool ShouldFilterOut(std::string_view word, const TypeFilter& type_filter) const;
 
   size_t min_word_length_ = 2;
   std::vector<models::WordType> embedding_preferred_types_;
   std::vector<models::WordType> dictionary_preferred_types_;
-  std::unordered_set<std::string> blacklisted_words_;
+  std::vector<TargetSampling> target_sampling_;
+  TypeFilter embedding_type_filter_;
+  TypeFilter dictionary_type_filter_;
+  std::unordered_set<std::string, StringHash, std::equal_to<>> blacklisted_words_;
 };
 
 }  // namespace contexto
@@ -0,0 +1,233 @@
+#include "game_event_log.hpp"
+
+#include <userver/components/component_config.hpp>
+#include <userver/components/component_context.hpp>
+#include <userver/components/statistics_storage.hpp>
+#include <userver/compiler/thread_local.hpp>
+#include <userver/logging/log.hpp>
+#include <userver/utils/statistics/writer.hpp>
+#include <userver/yaml_config/merge_schemas.hpp>
+
+namespace contexto {
+
+namespace {
+
+// A task never yields between looking up its thread's ring and pushing into it, so the thread is the only
+// producer of that ring even though tasks migrate between threads. userver's ThreadLocal makes sure that the
+// compiler doesn't reuse the address of another thread's variable.
+struct ThreadRing {
+  const void* owner = nullptr;
+  void* ring = nullptr;
+};
+
+userver::compiler::ThreadLocal thread_ring_storage = [] { return ThreadRing{}; };
+userver::compiler::ThreadLocal log_sample_counter_storage = [] { return size_t{0}; };
+
+}  // namespace
+
+GameEventLog::GameEventLog(const userver::components::ComponentConfig& config,
+                           const userver::components::ComponentContext& context)
+    : LoggableComponentBase(config, context),
+      path_(config["path"].As<std::string>("logs/game-events.bin")),
+      ring_capacity_(config["ring-capacity"].As<size_t>(16384)),
+      max_file_size_(config["max-file-size"].As<size_t>(64 * 1024 * 1024)),
+      max_files_(config["max-files"].As<size_t>(5)),
+      log_sample_every_(config["log-sample-every"].As<size_t>(100)) {
+  const auto flush_interval = config["flush-interval"].As<std::chrono::milliseconds>(std::chrono::milliseconds{100});
+  const auto task_processor_name = config["fs-task-processor"].As<std::string>("fs-task-processor");
+
+  OpenFile();
+
+  // File writes block, so the drain runs on the fs task processor
+  userver::utils::PeriodicTask::Settings settings(flush_interval);
+  settings.task_processor = &context.GetTaskProcessor(task_processor_name);
+  drain_task_.Start("game-event-log-drain", settings, [this] { Drain(); });
+
+  statistics_holder_ =
+      context.FindComponent<userver::components::StatisticsStorage>().GetStorage().RegisterWriter(
+          "contexto.game-events", [this](userver::utils::statistics::Writer& writer) { WriteStatistics(writer); });
+
+  LOG_INFO() << "GameEventLog initialized with path=" << path_.string() << ", ring_capacity=" << ring_capacity_
+             << ", log_sample_every=" << log_sample_every_;
+}
+
+GameEventLog::~GameEventLog() {
+  statistics_holder_.Unregister();
+  drain_task_.Stop();
+
+  // Handlers are stopped by now, the last events are written before the file closes
+  Drain();
+}
+
+void GameEventLog::Push(GameEvent event) const noexcept {
+  if (GetThreadRing().TryPush(event)) return;
+
+  // The drain task fell behind; events are kept rather than dropped
+  std::lock_guard lock(overflow_mutex_);
+  overflow_.push_back(event);
+  overflowed_events_.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool GameEventLog::ShouldLogSample() const noexcept {
+  if (log_sample_every_ == 0) return false;
+  auto log_sample_counter = log_sample_counter_storage.Use();
+  return ++*log_sample_counter % log_sample_every_ == 0;
+}
+
+GameEventLog::Ring& GameEventLog::GetThreadRing() const {
+  auto thread_ring = thread_ring_storage.Use();
+  if (thread_ring->owner == this) return *static_cast<Ring*>(thread_ring->ring);
+
+  auto ring = std::make_unique<Ring>(ring_capacity_);
+  auto* ring_ptr = ring.get();
+  {
+    std::lock_guard lock(rings_mutex_);
+    rings_.push_back(std::move(ring));
+  }
+  *thread_ring = ThreadRing{.owner = this, .ring = ring_ptr};
+  return *ring_ptr;
+}
+
+void GameEventLog::Drain() {
+  drain_buffer_.clear();
+  {
+    std::lock_guard lock(rings_mutex_);
+    for (const auto& ring : rings_) {
+      GameEvent event;
+      while (ring->TryPop(event)) {
+        drain_buffer_.push_back(event);
+      }
+    }
+  }
+  {
+    std::lock_guard lock(overflow_mutex_);
+    drain_buffer_.insert(drain_buffer_.end(), overflow_.begin(), overflow_.end());
+    overflow_.clear();
+  }
+
+  if (drain_buffer_.empty()) return;
+
+  // Rings are drained one after another, so the file is only ordered per thread
+  WriteEvents(drain_buffer_);
+}
+
+void GameEventLog::WriteEvents(std::span<const GameEvent> events) {
+  if (file_size_ + events.size_bytes() > max_file_size_) {
+    RotateFiles();
+  }
+
+  if (!file_.is_open()) {
+    write_errors_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  file_.write(reinterpret_cast<const char*>(events.data()), static_cast<std::streamsize>(events.size_bytes()));
+  file_.flush();
+  if (!file_) {
+    LOG_ERROR() << "Failed to write game events to " << path_.string();
+    write_errors_.fetch_add(1, std::memory_order_relaxed);
+    file_.clear();
+    return;
+  }
+
+  file_size_ += events.size_bytes();
+  written_events_.fetch_add(events.size(), std::memory_order_relaxed);
+}
+
+void GameEventLog::OpenFile() {
+  std::error_code error;
+  if (path_.has_parent_path()) {
+    std::filesystem::create_directories(path_.parent_path(), error);
+  }
+
+  file_.open(path_, std::ios::binary | std::ios::app);
+  if (!file_.is_open()) {
+    LOG_ERROR() << "Failed to open game event log " << path_.string();
+    return;
+  }
+
+  file_size_ = std::filesystem::file_size(path_, error);
+  if (error || file_size_ > 0) return;
+
+  const uint32_t record_size = sizeof(GameEvent);
+  file_.write(kFileMagic.data(), static_cast<std::streamsize>(kFileMagic.size()));
+  file_.write(reinterpret_cast<const char*>(&kFileVersion), sizeof(kFileVersion));
+  file_.write(reinterpret_cast<const char*>(&record_size), sizeof(record_size));
+  file_size_ = kFileMagic.size() + sizeof(kFileVersion) + sizeof(record_size);
+}
+
+void GameEventLog::RotateFiles() {
+  file_.close();
+
+  // path.N-1 -> path.N, ..., path -> path.1; the oldest file is overwritten
+  std::error_code error;
+  const auto numbered = [&](size_t index) {
+    return std::filesystem::path(path_.string() + "." + std::to_string(index));
+  };
+  for (size_t index = max_files_; index > 1; --index) {
+    std::filesystem::rename(numbered(index - 1), numbered(index), error);
+  }
+  if (max_files_ > 0) {
+    std::filesystem::rename(path_, numbered(1), error);
+  } else {
+    std::filesystem::remove(path_, error);
+  }
+
+  rotations_.fetch_add(1, std::memory_order_relaxed);
+  OpenFile();
+}
+
+void GameEventLog::WriteStatistics(userver::utils::statistics::Writer& writer) const {
+  size_t buffered = 0;
+  {
+    std::lock_guard lock(rings_mutex_);
+    for (const auto& ring : rings_) {
+      buffered += ring->Size();
+    }
+  }
+
+  writer["buffered"] = buffered;
+  writer["written"] = written_events_.load(std::memory_order_relaxed);
+  writer["overflowed"] = overflowed_events_.load(std::memory_order_relaxed);
+  writer["rotations"] = rotations_.load(std::memory_order_relaxed);
+  writer["write-errors"] = write_errors_.load(std::memory_order_relaxed);
+}
+
+userver::yaml_config::Schema GameEventLog::GetStaticConfigSchema() {
+  return userver::yaml_config::MergeSchemas<userver::components::LoggableComponentBase>(R"(
+type: object
+description: Structured binary game event log
+additionalProperties: false
+properties:
+  path:
+    type: string
+    description: event file, rotated files get a .1, .2, ... suffix
+    defaultDescription: logs/game-events.bin
+  ring-capacity:
+    type: integer
+    description: events buffered per worker thread between drains
+    defaultDescription: 16384
+  flush-interval:
+    type: string
+    description: how often the buffered events are written
+    defaultDescription: 100ms
+  max-file-size:
+    type: integer
+    description: size in bytes after which the file is rotated
+    defaultDescription: 67108864
+  max-files:
+    type: integer
+    description: number of rotated files kept
+    defaultDescription: 5
+  log-sample-every:
+    type: integer
+    description: write a human-readable log line for every N-th event per thread, 0 disables them
+    defaultDescription: 100
+  fs-task-processor:
+    type: string
+    description: task processor for the blocking file writes
+    defaultDescription: fs-task-processor
+)");
+}
+
+}  // namespace contexto
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <pch.hpp>
+
+#include <utils/fnv1a.hpp>
+#include <utils/spsc_ring.hpp>
+
+#include <userver/components/loggable_component_base.hpp>
+#include <userver/engine/mutex.hpp>
+#include <userver/utils/periodic_task.hpp>
+#include <userver/utils/statistics/entry.hpp>
+
+namespace contexto {
+
+enum class GameEventType : uint8_t {
+  kNewGame = 1,
+  kGuess = 2,
+  kGiveUp = 3,
+};
+
+enum GameEventFlags : uint8_t {
+  kGameEventDaily = 1 << 0,      // New game joined the daily puzzle
+  kGameEventPooled = 1 << 1,     // New game came from the prepared game pool
+  kGameEventCorrected = 1 << 2,  // Guess was auto-corrected
+  kGameEventBareWord = 1 << 3,   // Guess had no POS tag, word_index is its first POS variant
+  kGameEventTiered = 1 << 4,     // New game target was drawn from a difficulty tier
+};
+
+// Fixed-size binary record of the structured game-event stream, written to the event file as is
+struct GameEvent {
+  int64_t timestamp_ns = 0;  // System clock
+  uint64_t session = 0;      // Hash of the session id
+  uint32_t word_index = 0;   // Embedding index of the guess, or of the target for new games and give-ups
+  int16_t rank = -1;         // Guesses only
+  GameEventType type = GameEventType::kGuess;
+  uint8_t flags = 0;
+};
+
+static_assert(sizeof(GameEvent) == 24 && std::is_trivially_copyable_v<GameEvent>);
+
+// Structured game events off the request path. Handlers push records into a lock-free ring of their worker
+// thread; a background task on the fs task processor drains all rings into size-rotated binary files.
+// Human-readable per-event logs are sampled instead of written for every event.
+class GameEventLog final : public userver::components::LoggableComponentBase {
+public:
+  static constexpr std::string_view kName = "game-event-log";
+
+  // File header: magic, format version and record size, so readers can check the layout
+  static constexpr std::string_view kFileMagic = "CTXEVLOG";
+  static constexpr uint32_t kFileVersion = 2;  // 2: sessions hashed with FNV-1a
+
+  GameEventLog(const userver::components::ComponentConfig& config,
+               const userver::components::ComponentContext& context);
+  ~GameEventLog() override;
+
+  // Never blocks on the drain task and never drops: a full ring spills into a locked overflow buffer
+  void Push(GameEvent event) const noexcept;
+
+  // True for every log_sample_every-th call on this thread, false always if sampling is off
+  bool ShouldLogSample() const noexcept;
+
+  // Stable across builds, so sessions in files written by different binaries can be joined
+  static uint64_t HashSession(std::string_view session_id) noexcept { return utils::Fnv1a(session_id); }
+
+  static int64_t Now() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+  }
+
+  static userver::yaml_config::Schema GetStaticConfigSchema();
+
+private:
+  using Ring = utils::SpscRing<GameEvent>;
+
+  Ring& GetThreadRing() const;
+  void Drain();
+  void WriteEvents(std::span<const GameEvent> events);
+  void OpenFile();
+  void RotateFiles();
+
+  void WriteStatistics(userver::utils::statistics::Writer& writer) const;
+
+  std::filesystem::path path_;
+  size_t ring_capacity_ = 0;
+  size_t max_file_size_ = 0;
+  size_t max_files_ = 0;
+  size_t log_sample_every_ = 0;
+
+  // Rings are created on the first push of every thread and live as long as the component. A std::mutex, since
+  // waiting for an engine one could resume the pushing task on another thread while it registers its ring.
+  mutable std::mutex rings_mutex_;
+  mutable std::vector<std::unique_ptr<Ring>> rings_;
+
+  mutable userver::engine::Mutex overflow_mutex_;
+  mutable std::vector<GameEvent> overflow_;
+
+  // Only the drain task and the destructor touch the file
+  std::ofstream file_;
+  size_t file_size_ = 0;
+  std::vector<GameEvent> drain_buffer_;
+
+  mutable std::atomic<size_t> overflowed_events_ = 0;
+  std::atomic<size_t> written_events_ = 0;
+  std::atomic<size_t> rotations_ = 0;
+  std::atomic<size_t> write_errors_ = 0;
+  userver::utils::PeriodicTask drain_task_;
+  userver::utils::statistics::Entry statistics_holder_;
+};
+
+}  // namespace contexto
@@ -0,0 +1,110 @@
+#include "game_pool_component.hpp"
+#include "rank_table_cache.hpp"
+#include "word_dictionary_component.hpp"
+
+#include <userver/components/component_config.hpp>
+#include <userver/components/component_context.hpp>
+#include <userver/components/statistics_storage.hpp>
+#include <userver/logging/log.hpp>
+#include <userver/utils/statistics/writer.hpp>
+#include <userver/yaml_config/merge_schemas.hpp>
+
+namespace contexto {
+
+GamePoolComponent::GamePoolComponent(const userver::components::ComponentConfig& config,
+                                     const userver::components::ComponentContext& context)
+    : LoggableComponentBase(config, context),
+      dictionary_(context.FindComponent<WordDictionaryComponent>()),
+      rank_tables_(context.FindComponent<RankTableCache>()),
+      pool_size_(config["pool-size"].As<size_t>(16)),
+      refill_batch_(config["refill-batch"].As<size_t>(2)),
+      queue_(Queue::Create(pool_size_)),
+      producer_(queue_->GetMultiProducer()),
+      consumer_(queue_->GetMultiConsumer()) {
+  const auto refill_interval = config["refill-interval"].As<std::chrono::milliseconds>(std::chrono::milliseconds{500});
+  const auto task_processor_name = config["task-processor"].As<std::string>("compute-task-processor");
+
+  // Picking targets is cheap, but the tables behind them are CPU-bound and kept away from request handling
+  userver::utils::PeriodicTask::Settings settings(refill_interval, {userver::utils::PeriodicTask::Flags::kNow});
+  settings.task_processor = &context.GetTaskProcessor(task_processor_name);
+  refill_task_.Start("game-pool-refill", settings, [this] { Refill(); });
+
+  statistics_holder_ =
+      context.FindComponent<userver::components::StatisticsStorage>().GetStorage().RegisterWriter(
+          "contexto.game-pool", [this](userver::utils::statistics::Writer& writer) { WriteStatistics(writer); });
+
+  LOG_INFO() << "GamePoolComponent initialized with pool_size=" << pool_size_ << ", refill_batch=" << refill_batch_
+             << ", refill_interval=" << refill_interval.count() << "ms";
+}
+
+GamePoolComponent::~GamePoolComponent() {
+  statistics_holder_.Unregister();
+  refill_task_.Stop();
+}
+
+std::shared_ptr<const RankTable> GamePoolComponent::TryPop() const {
+  std::shared_ptr<const RankTable> game;
+  if (!consumer_.PopNoblock(game)) {
+    empty_pops_.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+  return game;
+}
+
+void GamePoolComponent::Refill() {
+  // At most refill_batch games per interval bounds the CPU the pool takes after a burst of new games
+  for (size_t built = 0; built < refill_batch_ && queue_->GetSizeApproximate() < pool_size_; ++built) {
+    const models::DictionaryWord* target = dictionary_.SelectTargetWord(rng_());
+    if (!target) {
+      LOG_ERROR() << "Failed to select a target word for the game pool";
+      return;
+    }
+
+    // Targets drawn again while their table is still cached cost nothing
+    const auto build_start = std::chrono::steady_clock::now();
+    auto game = rank_tables_.Get(*target);
+    const auto build_duration =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - build_start);
+    last_build_duration_ms_.store(build_duration.count(), std::memory_order_relaxed);
+    if (!game) return;
+
+    // Only this task produces, so the pool can't have filled up since the size check
+    if (!producer_.PushNoblock(std::move(game))) return;
+    prepared_games_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void GamePoolComponent::WriteStatistics(userver::utils::statistics::Writer& writer) const {
+  writer["depth"] = queue_->GetSizeApproximate();
+  writer["capacity"] = pool_size_;
+  writer["prepared"] = prepared_games_.load(std::memory_order_relaxed);
+  writer["empty-pops"] = empty_pops_.load(std::memory_order_relaxed);
+  writer["last-build-duration-ms"] = last_build_duration_ms_.load(std::memory_order_relaxed);
+}
+
+userver::yaml_config::Schema GamePoolComponent::GetStaticConfigSchema() {
+  return userver::yaml_config::MergeSchemas<userver::components::LoggableComponentBase>(R"(
+type: object
+description: Pool of prepared private games
+additionalProperties: false
+properties:
+  pool-size:
+    type: integer
+    description: maximum number of prepared games, each holds a rank table of 4 bytes per embedding
+    defaultDescription: 16
+  refill-batch:
+    type: integer
+    description: maximum number of games prepared per refill interval
+    defaultDescription: 2
+  refill-interval:
+    type: string
+    description: how often the pool is topped up
+    defaultDescription: 500ms
+  task-processor:
+    type: string
+    description: task processor the games are prepared on
+    defaultDescription: compute-task-processor
+)");
+}
+
+}  // namespace contexto
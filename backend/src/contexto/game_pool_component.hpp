@@ -0,0 +1,56 @@
+#pragma once
+
+#include "rank_table.hpp"
+
+#include <userver/components/loggable_component_base.hpp>
+#include <userver/concurrent/queue.hpp>
+#include <userver/utils/periodic_task.hpp>
+#include <userver/utils/statistics/entry.hpp>
+
+namespace contexto {
+
+class RankTableCache;
+class WordDictionaryComponent;
+
+// Bounded pool of prepared private games. A background task on the compute task processor picks targets and
+// gets their rank tables, so starting a game is a lock-free queue pop instead of per-target work.
+class GamePoolComponent final : public userver::components::LoggableComponentBase {
+public:
+  static constexpr std::string_view kName = "game-pool";
+
+  GamePoolComponent(const userver::components::ComponentConfig& config,
+                    const userver::components::ComponentContext& context);
+  ~GamePoolComponent() override;
+
+  // Takes a prepared game, nullptr if the pool is drained
+  std::shared_ptr<const RankTable> TryPop() const;
+
+  static userver::yaml_config::Schema GetStaticConfigSchema();
+
+private:
+  using Queue = userver::concurrent::MpmcQueue<std::shared_ptr<const RankTable>>;
+
+  void Refill();
+
+  void WriteStatistics(userver::utils::statistics::Writer& writer) const;
+
+  const WordDictionaryComponent& dictionary_;
+  const RankTableCache& rank_tables_;
+  size_t pool_size_ = 0;
+  size_t refill_batch_ = 0;
+
+  std::shared_ptr<Queue> queue_;
+  Queue::MultiProducer producer_;
+  mutable Queue::MultiConsumer consumer_;
+
+  // Only the refill task draws targets, so the generator needs no lock
+  std::mt19937_64 rng_{std::random_device{}()};
+
+  std::atomic<size_t> prepared_games_ = 0;
+  mutable std::atomic<size_t> empty_pops_ = 0;
+  std::atomic<int64_t> last_build_duration_ms_ = 0;
+  userver::utils::PeriodicTask refill_task_;
+  userver::utils::statistics::Entry statistics_holder_;
+};
+
+}  // namespace contexto
@@ -1,22 +1,28 @@
 #pragma once
 
-#include <userver/server/handlers/http_handler_base.hpp>
+#include "cors_handler_base.hpp"
 
 namespace contexto {
 
+class GameEventLog;
 class SessionManager;
+class WordDictionaryComponent;
 
-class GiveUpHandler final : public userver::server::handlers::HttpHandlerBase {
+class GiveUpHandler final : public CorsHandlerBase {
 public:
   static constexpr std::string_view kName = "contexto-give-up-handler";
 
   GiveUpHandler(const userver::components::ComponentConfig&, const userver::components::ComponentContext&);
 
-  std::string HandleRequestThrow(const userver::server::http::HttpRequest&,
-                                 userver::server::request::RequestContext&) const override;
+protected:
+  std::string HandleApiRequest(const userver::server::http::HttpRequest&,
+                               userver::server::request::RequestContext&,
+                               std::pmr::memory_resource& arena) const override;
 
 private:
   SessionManager& session_manager_;
+  const WordDictionaryComponent& dictionary_;
+  const GameEventLog& event_log_;
 };
 
 }  // namespace contexto
@@ -0,0 +1,299 @@
+#include "guess_analytics.hpp"
+#include "word_dictionary_component.hpp"
+
+#include <userver/components/component_config.hpp>
+#include <userver/components/component_context.hpp>
+#include <userver/components/statistics_storage.hpp>
+#include <userver/formats/json/string_builder.hpp>
+#include <userver/logging/log.hpp>
+#include <userver/utils/statistics/writer.hpp>
+#include <userver/yaml_config/merge_schemas.hpp>
+
+namespace contexto {
+
+namespace {
+
+using userver::formats::json::StringBuilder;
+
+// Power-of-two buckets: 1, 2, 3-4, 5-8, ...
+size_t Bucket(size_t value, size_t bucket_count) noexcept {
+  if (value <= 1) return 0;
+  return std::min<size_t>(std::bit_width(value - 1), bucket_count - 1);
+}
+
+uint64_t BucketLowerBound(size_t bucket) noexcept { return bucket == 0 ? 1 : (uint64_t{1} << (bucket - 1)) + 1; }
+
+void WriteBucketBounds(StringBuilder& builder, size_t bucket_count) {
+  const StringBuilder::ArrayGuard guard(builder);
+  for (size_t bucket = 0; bucket < bucket_count; ++bucket) {
+    WriteToStream(BucketLowerBound(bucket), builder);
+  }
+}
+
+}  // namespace
+
+GuessAnalytics::TargetStats::TargetStats(size_t sketch_width, size_t sketch_depth, size_t heavy_hitter_capacity)
+    : sketch(sketch_width, sketch_depth) {
+  for (auto& shard : heavy_hitters) {
+    shard = std::make_unique<HeavyHitterShard>(heavy_hitter_capacity);
+  }
+}
+
+GuessAnalytics::GuessAnalytics(const userver::components::ComponentConfig& config,
+                               const userver::components::ComponentContext& context)
+    : LoggableComponentBase(config, context),
+      dictionary_(context.FindComponent<WordDictionaryComponent>()),
+      sketch_width_(config["sketch-width"].As<size_t>(1024)),
+      sketch_depth_(config["sketch-depth"].As<size_t>(4)),
+      heavy_hitters_(config["heavy-hitters"].As<size_t>(32)),
+      max_targets_(config["max-targets"].As<size_t>(512)),
+      flush_path_(config["flush-path"].As<std::string>("logs/guess-analytics.json")),
+      flush_targets_(config["flush-targets"].As<size_t>(100)) {
+  const auto flush_interval = config["flush-interval"].As<std::chrono::milliseconds>(std::chrono::minutes{1});
+  const auto task_processor_name = config["fs-task-processor"].As<std::string>("fs-task-processor");
+
+  // Snapshots are written with blocking file calls, so the flush runs on the fs task processor
+  userver::utils::PeriodicTask::Settings settings(flush_interval);
+  settings.task_processor = &context.GetTaskProcessor(task_processor_name);
+  flush_task_.Start("guess-analytics-flush", settings, [this] { Flush(); });
+
+  statistics_holder_ =
+      context.FindComponent<userver::components::StatisticsStorage>().GetStorage().RegisterWriter(
+          "contexto.guess-analytics", [this](userver::utils::statistics::Writer& writer) { WriteStatistics(writer); });
+
+  LOG_INFO() << "GuessAnalytics initialized with max_targets=" << max_targets_ << ", sketch=" << sketch_width_ << "x"
+             << sketch_depth_ << ", heavy_hitters=" << heavy_hitters_;
+}
+
+GuessAnalytics::~GuessAnalytics() {
+  statistics_holder_.Unregister();
+  flush_task_.Stop();
+}
+
+void GuessAnalytics::RecordGuess(size_t target_index, size_t word_index, int rank, size_t guess_number) const {
+  const auto stats = GetOrCreateTarget(static_cast<uint32_t>(target_index));
+  if (!stats) {
+    untracked_guesses_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  stats->guesses.fetch_add(1, std::memory_order_relaxed);
+  if (rank == 1) stats->solved.fetch_add(1, std::memory_order_relaxed);
+  stats->sketch.Add(word_index);
+  stats->ranks[Bucket(guess_number, kGuessBuckets)][Bucket(static_cast<size_t>(std::max(rank, 1)), kRankBuckets)]
+      .fetch_add(1, std::memory_order_relaxed);
+
+  auto& shard = *stats->heavy_hitters[word_index % kHeavyHitterShards];
+  std::lock_guard lock(shard.mutex);
+  shard.top.Add(static_cast<uint32_t>(word_index));
+}
+
+std::shared_ptr<GuessAnalytics::TargetStats> GuessAnalytics::GetOrCreateTarget(uint32_t target_index) const {
+  auto& shard = shards_[target_index % kTargetShards];
+  {
+    std::shared_lock lock(shard.mutex);
+    const auto it = shard.targets.find(target_index);
+    if (it != shard.targets.end()) return it->second;
+  }
+
+  // Targets beyond the limit are counted but not tracked until the next flush evicts cold ones
+  if (tracked_targets_.load(std::memory_order_relaxed) >= max_targets_) return nullptr;
+
+  std::lock_guard lock(shard.mutex);
+  auto& stats = shard.targets[target_index];
+  if (!stats) {
+    stats = std::make_shared<TargetStats>(sketch_width_, sketch_depth_, heavy_hitters_);
+    tracked_targets_.fetch_add(1, std::memory_order_relaxed);
+  }
+  return stats;
+}
+
+std::vector<std::pair<uint32_t, std::shared_ptr<GuessAnalytics::TargetStats>>> GuessAnalytics::CollectTargets() const {
+  std::vector<std::pair<uint32_t, std::shared_ptr<TargetStats>>> targets;
+  for (const auto& shard : shards_) {
+    std::shared_lock lock(shard.mutex);
+    targets.insert(targets.end(), shard.targets.begin(), shard.targets.end());
+  }
+
+  std::sort(targets.begin(), targets.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.second->guesses.load(std::memory_order_relaxed) > rhs.second->guesses.load(std::memory_order_relaxed);
+  });
+  return targets;
+}
+
+std::string GuessAnalytics::MakeSnapshot(size_t targets_limit, size_t top_guesses_limit,
+                                         std::optional<size_t> target_index,
+                                         std::optional<size_t> estimate_word_index) const {
+  auto targets = CollectTargets();
+  if (target_index) {
+    std::erase_if(targets, [&](const auto& target) { return target.first != *target_index; });
+  }
+  if (targets.size() > targets_limit) targets.resize(targets_limit);
+
+  const auto& dictionary = dictionary_.GetDictionary();
+  const auto word_of = [&](size_t index) {
+    const auto* word = dictionary.TryGetWordWithEmbeddingByIndex(index);
+    return word ? std::string_view(word->word_with_pos) : std::string_view{};
+  };
+
+  StringBuilder builder;
+  {
+    const StringBuilder::ObjectGuard guard(builder);
+    builder.Key("guess_buckets");
+    WriteBucketBounds(builder, kGuessBuckets);
+    builder.Key("rank_buckets");
+    WriteBucketBounds(builder, kRankBuckets);
+    builder.Key("tracked_targets");
+    WriteToStream(static_cast<uint64_t>(tracked_targets_.load(std::memory_order_relaxed)), builder);
+    builder.Key("untracked_guesses");
+    WriteToStream(untracked_guesses_.load(std::memory_order_relaxed), builder);
+
+    builder.Key("targets");
+    const StringBuilder::ArrayGuard targets_guard(builder);
+    for (const auto& [index, stats] : targets) {
+      const StringBuilder::ObjectGuard target_guard(builder);
+      builder.Key("target");
+      WriteToStream(word_of(index), builder);
+      builder.Key("guesses");
+      WriteToStream(stats->guesses.load(std::memory_order_relaxed), builder);
+      builder.Key("solved");
+      WriteToStream(stats->solved.load(std::memory_order_relaxed), builder);
+
+      if (estimate_word_index) {
+        builder.Key("estimated_count");
+        WriteToStream(static_cast<uint64_t>(stats->sketch.Estimate(*estimate_word_index)), builder);
+      }
+
+      std::vector<utils::SpaceSaving<uint32_t>::Entry> top_guesses;
+      for (const auto& shard : stats->heavy_hitters) {
+        std::lock_guard lock(shard->mutex);
+        const auto& entries = shard->top.Entries();
+        top_guesses.insert(top_guesses.end(), entries.begin(), entries.end());
+      }
+      std::sort(top_guesses.begin(), top_guesses.end(),
+                [](const auto& lhs, const auto& rhs) { return lhs.count > rhs.count; });
+      if (top_guesses.size() > top_guesses_limit) top_guesses.resize(top_guesses_limit);
+
+      builder.Key("top_guesses");
+      {
+        const StringBuilder::ArrayGuard top_guard(builder);
+        for (const auto& entry : top_guesses) {
+          const StringBuilder::ObjectGuard entry_guard(builder);
+          builder.Key("word");
+          WriteToStream(word_of(entry.key), builder);
+          builder.Key("count");
+          WriteToStream(entry.count, builder);
+          builder.Key("error");
+          WriteToStream(entry.error, builder);
+        }
+      }
+
+      // One row per guess bucket, one column per rank bucket
+      builder.Key("rank_progression");
+      const StringBuilder::ArrayGuard progression_guard(builder);
+      for (const auto& row : stats->ranks) {
+        const StringBuilder::ArrayGuard row_guard(builder);
+        for (const auto& count : row) {
+          WriteToStream(static_cast<uint64_t>(count.load(std::memory_order_relaxed)), builder);
+        }
+      }
+    }
+  }
+  return builder.GetString();
+}
+
+void GuessAnalytics::Flush() const {
+  if (!flush_path_.empty()) {
+    const auto snapshot = MakeSnapshot(flush_targets_, heavy_hitters_);
+
+    // Written next to the target and renamed over it, so readers never see a partial snapshot
+    const std::filesystem::path path(flush_path_);
+    const std::filesystem::path temp_path(flush_path_ + ".tmp");
+    std::error_code error;
+    if (path.has_parent_path()) std::filesystem::create_directories(path.parent_path(), error);
+
+    std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+    file << snapshot;
+    file.close();
+    if (file) std::filesystem::rename(temp_path, path, error);
+
+    if (!file || error) {
+      LOG_ERROR() << "Failed to write guess analytics to " << flush_path_;
+      flush_errors_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  EvictColdTargets();
+}
+
+void GuessAnalytics::EvictColdTargets() const {
+  if (tracked_targets_.load(std::memory_order_relaxed) < max_targets_) return;
+
+  // The less guessed half makes room for new targets; in-flight updates keep their stats alive until done
+  auto targets = CollectTargets();
+  const size_t keep = max_targets_ / 2;
+  for (size_t i = keep; i < targets.size(); ++i) {
+    auto& shard = shards_[targets[i].first % kTargetShards];
+    std::lock_guard lock(shard.mutex);
+    if (shard.targets.erase(targets[i].first) > 0) {
+      tracked_targets_.fetch_sub(1, std::memory_order_relaxed);
+      evicted_targets_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+}
+
+void GuessAnalytics::WriteStatistics(userver::utils::statistics::Writer& writer) const {
+  const size_t targets = tracked_targets_.load(std::memory_order_relaxed);
+  const size_t target_size = sizeof(TargetStats) + sketch_width_ * sketch_depth_ * sizeof(uint32_t) +
+                             kHeavyHitterShards * (sizeof(HeavyHitterShard) +
+                                                   heavy_hitters_ * sizeof(utils::SpaceSaving<uint32_t>::Entry));
+
+  writer["targets"] = targets;
+  writer["memory-bytes"] = targets * target_size;
+  writer["untracked-guesses"] = untracked_guesses_.load(std::memory_order_relaxed);
+  writer["evicted-targets"] = evicted_targets_.load(std::memory_order_relaxed);
+  writer["flush-errors"] = flush_errors_.load(std::memory_order_relaxed);
+}
+
+userver::yaml_config::Schema GuessAnalytics::GetStaticConfigSchema() {
+  return userver::yaml_config::MergeSchemas<userver::components::LoggableComponentBase>(R"(
+type: object
+description: Per-target guess analytics in bounded memory
+additionalProperties: false
+properties:
+  sketch-width:
+    type: integer
+    description: counters per Count-Min row, rounded up to a power of two
+    defaultDescription: 1024
+  sketch-depth:
+    type: integer
+    description: Count-Min rows
+    defaultDescription: 4
+  heavy-hitters:
+    type: integer
+    description: most frequent guesses tracked per target and shard
+    defaultDescription: 32
+  max-targets:
+    type: integer
+    description: targets tracked at once, the less guessed half is evicted on flush when the limit is reached
+    defaultDescription: 512
+  flush-interval:
+    type: string
+    description: how often a snapshot is written
+    defaultDescription: 1m
+  flush-path:
+    type: string
+    description: snapshot file, empty disables writing snapshots
+    defaultDescription: logs/guess-analytics.json
+  flush-targets:
+    type: integer
+    description: most guessed targets included in a written snapshot
+    defaultDescription: 100
+  fs-task-processor:
+    type: string
+    description: task processor for the blocking file writes
+    defaultDescription: fs-task-processor
+)");
+}
+
+}  // namespace contexto
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <pch.hpp>
+
+#include <utils/count_min_sketch.hpp>
+#include <utils/space_saving.hpp>
+
+#include <userver/components/loggable_component_base.hpp>
+#include <userver/engine/mutex.hpp>
+#include <userver/engine/shared_mutex.hpp>
+#include <userver/utils/periodic_task.hpp>
+#include <userver/utils/statistics/entry.hpp>
+
+namespace contexto {
+
+class WordDictionaryComponent;
+
+// Which words players guess for each target and how close they get, kept in bounded memory: a Count-Min sketch
+// of guess frequencies, Space-Saving heavy hitters and a histogram of ranks by guess number per target.
+// Guess updates are lock-free apart from a heavy-hitter shard lock; snapshots are served by the admin handler
+// and periodically written to a file.
+class GuessAnalytics final : public userver::components::LoggableComponentBase {
+public:
+  static constexpr std::string_view kName = "guess-analytics";
+
+  // Guess numbers 1, 2, 3-4, 5-8, ..., 65+ and ranks 1, 2, 3-4, 5-8, ..., 32769+
+  static constexpr size_t kGuessBuckets = 8;
+  static constexpr size_t kRankBuckets = 17;
+
+  GuessAnalytics(const userver::components::ComponentConfig& config,
+                 const userver::components::ComponentContext& context);
+  ~GuessAnalytics() override;
+
+  // guess_number counts the guesses of the session, starting at 1
+  void RecordGuess(size_t target_index, size_t word_index, int rank, size_t guess_number) const;
+
+  // JSON snapshot of the targets with the most guesses, or of a single target if target_index is set.
+  // estimate_word_index adds the sketch estimate for one guess word to every listed target.
+  std::string MakeSnapshot(size_t targets_limit, size_t top_guesses_limit, std::optional<size_t> target_index = {},
+                           std::optional<size_t> estimate_word_index = {}) const;
+
+  static userver::yaml_config::Schema GetStaticConfigSchema();
+
+private:
+  static constexpr size_t kTargetShards = 16;
+  static constexpr size_t kHeavyHitterShards = 4;
+
+  struct HeavyHitterShard {
+    userver::engine::Mutex mutex;
+    utils::SpaceSaving<uint32_t> top;
+
+    explicit HeavyHitterShard(size_t capacity) : top(capacity) {}
+  };
+
+  struct TargetStats {
+    TargetStats(size_t sketch_width, size_t sketch_depth, size_t heavy_hitter_capacity);
+
+    std::atomic<uint64_t> guesses = 0;
+    std::atomic<uint64_t> solved = 0;
+    utils::CountMinSketch sketch;
+
+    // Guesses are sharded by word, so every shard tracks its own keys and merging them stays exact
+    std::array<std::unique_ptr<HeavyHitterShard>, kHeavyHitterShards> heavy_hitters;
+    std::array<std::array<std::atomic<uint32_t>, kRankBuckets>, kGuessBuckets> ranks{};
+  };
+
+  // Targets are sharded by index so that concurrent games of different targets take different locks
+  struct TargetShard {
+    mutable userver::engine::SharedMutex mutex;
+    std::unordered_map<uint32_t, std::shared_ptr<TargetStats>> targets;
+  };
+
+  std::shared_ptr<TargetStats> GetOrCreateTarget(uint32_t target_index) const;
+  std::vector<std::pair<uint32_t, std::shared_ptr<TargetStats>>> CollectTargets() const;
+
+  void Flush() const;
+  void EvictColdTargets() const;
+
+  void WriteStatistics(userver::utils::statistics::Writer& writer) const;
+
+  const WordDictionaryComponent& dictionary_;
+
+  size_t sketch_width_;
+  size_t sketch_depth_;
+  size_t heavy_hitters_;
+  size_t max_targets_;
+  std::string flush_path_;
+  size_t flush_targets_;
+
+  mutable std::array<TargetShard, kTargetShards> shards_;
+  mutable std::atomic<size_t> tracked_targets_ = 0;
+
+  mutable std::atomic<uint64_t> untracked_guesses_ = 0;
+  mutable std::atomic<uint64_t> evicted_targets_ = 0;
+  mutable std::atomic<uint64_t> flush_errors_ = 0;
+  userver::utils::PeriodicTask flush_task_;
+  userver::utils::statistics::Entry statistics_holder_;
+};
+
+}  // namespace contexto
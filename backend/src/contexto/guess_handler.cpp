@@ -1,99 +1,146 @@
 #include "guess_handler.hpp"
+#include "api_json.hpp"
+#include "game_event_log.hpp"
+#include "guess_analytics.hpp"
+#include "rank_table.hpp"
 #include "session_manager.hpp"
 #include "word_dictionary_component.hpp"
 
+#include <userver/components/component_config.hpp>
 #include <userver/components/component_context.hpp>
-#include <userver/formats/json.hpp>
+#include <userver/components/statistics_storage.hpp>
 #include <userver/logging/log.hpp>
 #include <userver/server/http/http_status.hpp>
+#include <userver/utils/async.hpp>
+#include <userver/utils/statistics/writer.hpp>
+#include <userver/yaml_config/merge_schemas.hpp>
 
 namespace contexto {
 
 GuessHandler::GuessHandler(const userver::components::ComponentConfig& config,
                            const userver::components::ComponentContext& context)
-    : HttpHandlerBase(config, context),
+    : CorsHandlerBase(config, context),
       session_manager_(context.FindComponent<SessionManager>()),
-      dictionary_(context.FindComponent<WordDictionaryComponent>()) {
-  LOG_INFO() << "GuessHandler initialized";
-}
-
-std::string GuessHandler::HandleRequestThrow(const userver::server::http::HttpRequest& request,
-                                             userver::server::request::RequestContext&) const {
-  auto& http_response = request.GetHttpResponse();
-
-  // Set proper CORS headers
-  const auto& origin = request.GetHeader("Origin");
-  if (!origin.empty()) {
-    http_response.SetHeader(std::string_view("Access-Control-Allow-Origin"), origin);
-  } else {
-    http_response.SetHeader(std::string_view("Access-Control-Allow-Origin"), "*");
-  }
+      dictionary_(context.FindComponent<WordDictionaryComponent>()),
+      event_log_(context.FindComponent<GameEventLog>()),
+      analytics_(context.FindComponent<GuessAnalytics>()),
+      compute_task_processor_(
+          context.GetTaskProcessor(config["compute-task-processor"].As<std::string>("compute-task-processor"))),
+      auto_correct_(config["auto-correct"].As<bool>(false)),
+      max_correction_distance_(config["max-correction-distance"].As<size_t>(1)),
+      suggestions_limit_(config["suggestions-limit"].As<size_t>(3)) {
+  statistics_holder_ =
+      context.FindComponent<userver::components::StatisticsStorage>().GetStorage().RegisterWriter(
+          "contexto.guess", [this](userver::utils::statistics::Writer& writer) { WriteStatistics(writer); });
 
-  http_response.SetHeader(std::string_view("Access-Control-Allow-Methods"), "GET, POST, OPTIONS");
-  http_response.SetHeader(std::string_view("Access-Control-Allow-Headers"), "Content-Type, X-Requested-With");
-  http_response.SetHeader(std::string_view("Access-Control-Allow-Credentials"), "true");
+  LOG_INFO() << "GuessHandler initialized with auto_correct=" << auto_correct_
+             << ", max_correction_distance=" << max_correction_distance_
+             << ", suggestions_limit=" << suggestions_limit_;
+}
 
-  if (request.GetMethod() == userver::server::http::HttpMethod::kOptions) {
-    request.SetResponseStatus(userver::server::http::HttpStatus::kOk);
-    return "";
-  }
+GuessHandler::~GuessHandler() { statistics_holder_.Unregister(); }
 
+std::string GuessHandler::HandleApiRequest(const userver::server::http::HttpRequest& request,
+                                           userver::server::request::RequestContext&,
+                                           std::pmr::memory_resource& arena) const {
   try {
     const auto& body = request.RequestBody();
     if (body.empty()) {
       request.SetResponseStatus(userver::server::http::HttpStatus::kBadRequest);
       LOG_ERROR() << "Empty request body";
-      return userver::formats::json::ToString(userver::formats::json::MakeObject("error", "Empty request body"));
+      return api::MakeError("Empty request body");
     }
 
-    userver::formats::json::Value json;
+    statistics::ScopeLatency parse_latency(statistics_.parse);
+
+    std::pmr::string guessed_word(&arena);
     try {
-      json = userver::formats::json::FromString(body);
+      guessed_word = api::ParseStringField(body, "word", arena);
 
-    } catch (const userver::formats::json::Exception& e) {
+    } catch (const std::exception& e) {
       request.SetResponseStatus(userver::server::http::HttpStatus::kBadRequest);
       LOG_ERROR() << "Invalid JSON: " << e.what();
-      return userver::formats::json::ToString(userver::formats::json::MakeObject("error", "Invalid JSON format"));
+      return api::MakeError("Invalid JSON format");
     }
 
-    std::string guessed_word = json["word"].As<std::string>();
     if (guessed_word.empty()) {
       request.SetResponseStatus(userver::server::http::HttpStatus::kBadRequest);
       LOG_ERROR() << "No word provided";
-      return userver::formats::json::ToString(userver::formats::json::MakeObject("error", "Word cannot be empty"));
+      return api::MakeError("Word cannot be empty");
+    }
+
+    // Malformed UTF-8 is rejected before any dictionary lookup
+    if (!utils::utf8::IsValid(guessed_word)) {
+      request.SetResponseStatus(userver::server::http::HttpStatus::kBadRequest);
+      LOG_ERROR() << "Malformed UTF-8 in submitted word";
+      return api::MakeError("Invalid word encoding");
     }
 
+    parse_latency.Stop();
+
+    statistics::ScopeLatency session_lookup_latency(statistics_.session_lookup);
+
     // Get session ID from cookie
     const auto& session_id = request.GetCookie("session_id");
     if (session_id.empty()) {
       request.SetResponseStatus(userver::server::http::HttpStatus::kBadRequest);
       LOG_ERROR() << "No session_id found (neither in cookie nor in request body)";
-      return userver::formats::json::ToString(userver::formats::json::MakeObject("error", "No active game session"));
+      return api::MakeError("No active game session");
     }
 
     // Get target word for this session
     if (!session_manager_.HasSession(session_id)) {
       request.SetResponseStatus(userver::server::http::HttpStatus::kBadRequest);
       LOG_ERROR() << "Session " << "'" << session_id << "'" << " not found in session manager";
-      return userver::formats::json::ToString(userver::formats::json::MakeObject("error", "Invalid game session"));
+      return api::MakeError("Invalid game session");
     }
 
     if (session_manager_.IsGameOver(session_id)) {
       request.SetResponseStatus(userver::server::http::HttpStatus::kBadRequest);
       LOG_INFO() << "Game is already over for session " << session_id;
-      return userver::formats::json::ToString(
-          userver::formats::json::MakeObject("error", "Game is already over. Start a new game to continue."));
+      return api::MakeError("Game is already over. Start a new game to continue.");
     }
 
     const std::string_view target_word_with_pos = session_manager_.GetTargetWord(session_id);
-    if (!dictionary_.ValidateWord(guessed_word)) {
-      request.SetResponseStatus(userver::server::http::HttpStatus::kBadRequest);
-      LOG_ERROR() << "Unknown word submitted: '" << guessed_word << "'";
-      return userver::formats::json::ToString(userver::formats::json::MakeObject("error", "Invalid word"));
+    const auto rank_table = session_manager_.GetRankTable(session_id);
+    session_lookup_latency.Stop();
+
+    // Casing and ё/е spelling are resolved to the dictionary spelling of the word
+    statistics::ScopeLatency word_lookup_latency(statistics_.word_lookup);
+    std::string_view canonical_word = dictionary_.ResolveWord(guessed_word);
+    std::string_view corrected_from;
+    if (canonical_word.empty()) {
+      // Fetch one extra candidate to tell whether the closest one is unambiguous
+      const size_t limit = std::max(suggestions_limit_, auto_correct_ ? size_t{2} : size_t{0});
+      const auto suggestions = max_correction_distance_ > 0
+                                   ? dictionary_.SuggestSpellings(guessed_word, max_correction_distance_, limit, arena)
+                                   : std::pmr::vector<SpellingSuggestion>(&arena);
+
+      const bool is_unambiguous =
+          suggestions.size() == 1 || (suggestions.size() > 1 && suggestions[0].distance < suggestions[1].distance);
+      if (!auto_correct_ || !is_unambiguous) {
+        request.SetResponseStatus(userver::server::http::HttpStatus::kBadRequest);
+        LOG_ERROR() << "Unknown word submitted: '" << guessed_word << "', " << suggestions.size() << " suggestions";
+
+        std::pmr::vector<std::string_view> suggested_words(&arena);
+        suggested_words.reserve(std::min(suggestions.size(), suggestions_limit_));
+        for (size_t i = 0; i < std::min(suggestions.size(), suggestions_limit_); ++i) {
+          suggested_words.push_back(suggestions[i].word);
+        }
+        return api::MakeUnknownWordError(suggested_words);
+      }
+
+      corrected_from = guessed_word;
+      canonical_word = suggestions.front().word;
     }
 
+    word_lookup_latency.Stop();
+
 #ifdef DEBUG_MODE
-    const auto temp = dictionary_.GetDictionary().GetMostSimilarWords(target_word_with_pos, 100);
+    // A full vocabulary scan, kept off the HTTP workers
+    const auto temp = userver::utils::Async(compute_task_processor_, "most-similar-words", [&] {
+                        return dictionary_.GetDictionary().GetMostSimilarWords(target_word_with_pos, 100);
+                      }).Get();
     std::ostringstream ss;
     ss << "Most similar words to target '" << target_word_with_pos << "': ";
     int count = 0;
@@ -105,30 +152,106 @@ std::string GuessHandler::HandleRequestThrow(const userver::server::http::HttpRe
     LOG_INFO() << ss.str();
 #endif
 
-    const auto rank_result = dictionary_.CalculateRank(guessed_word, target_word_with_pos);
+    // Both words are resolved once, ranking itself works on embedding indices
+    const bool has_pos = models::WordHasPOS(canonical_word);
+    const auto word_index = dictionary_.GetDictionary().FindWordIndex(canonical_word);
+    const auto target_index = dictionary_.GetDictionary().FindWordIndex(target_word_with_pos);
+    const GuessedWord guessed{.index = static_cast<uint32_t>(word_index.value_or(0)), .has_pos = has_pos};
+
+    // A repeated word gets the rank it got before and is neither ranked nor recorded again. This is only the
+    // cheap path, a submission racing with the first one is caught when the guess is stored.
+    if (const auto previous_rank = word_index ? session_manager_.FindGuessRank(session_id, guessed) : std::nullopt) {
+      statistics_.duplicates.fetch_add(1, std::memory_order_relaxed);
+      return api::MakeGuessResponse(canonical_word, *previous_rank, corrected_from, /*duplicate=*/true);
+    }
+
+    // Prepared games read the precomputed rank, the rest compute it
+    statistics::ScopeLatency rank_latency(statistics_.rank);
+    std::optional<int> rank_result;
+    if (word_index && target_index) {
+      rank_result = rank_table ? rank_table->GetRank(*word_index, has_pos)
+                               : dictionary_.CalculateRank(*word_index, has_pos, *target_index);
+    }
+    rank_latency.Stop();
+
     if (!rank_result) {
       request.SetResponseStatus(userver::server::http::HttpStatus::kInternalServerError);
       constexpr std::string_view error = "Failed to calculate rank";
       LOG_ERROR() << "Error processing guess: " << error;
-      return userver::formats::json::ToString(userver::formats::json::MakeObject("error", error));
+      return api::MakeError(error);
     }
 
     const int rank = *rank_result;
 
-    const auto response =
-        userver::formats::json::MakeObject("word", guessed_word, "rank", rank, "correct", (rank == 1 ? "yes" : "no"));
+    const auto added = session_manager_.AddGuess(session_id, guessed, rank);
+    if (added.previous_rank) {
+      statistics_.duplicates.fetch_add(1, std::memory_order_relaxed);
+      return api::MakeGuessResponse(canonical_word, *added.previous_rank, corrected_from, /*duplicate=*/true);
+    }
 
-    LOG_INFO() << "Guess: " << guessed_word << ", Rank: " << rank << ", Correct: " << (rank == 1 ? "yes" : "no");
+    statistics::ScopeLatency serialize_latency(statistics_.serialize);
+    std::string response_body = api::MakeGuessResponse(canonical_word, rank, corrected_from);
+    serialize_latency.Stop();
 
-    session_manager_.AddGuess(session_id, std::move(guessed_word), rank);
+    event_log_.Push(GameEvent{
+        .timestamp_ns = GameEventLog::Now(),
+        .session = GameEventLog::HashSession(session_id),
+        .word_index = static_cast<uint32_t>(word_index.value_or(0)),
+        .rank = static_cast<int16_t>(std::min(rank, int{std::numeric_limits<int16_t>::max()})),
+        .type = GameEventType::kGuess,
+        .flags = static_cast<uint8_t>((corrected_from.empty() ? 0 : kGameEventCorrected) |
+                                      (has_pos ? 0 : kGameEventBareWord)),
+    });
+    if (event_log_.ShouldLogSample()) {
+      LOG_INFO() << "Guess: " << canonical_word << (corrected_from.empty() ? "" : " (auto-corrected)")
+                 << ", Rank: " << rank << ", Correct: " << (rank == 1 ? "yes" : "no");
+    }
+
+    analytics_.RecordGuess(*target_index, *word_index, rank, added.guess_number);
 
-    return userver::formats::json::ToString(response);
+    return response_body;
 
   } catch (const std::exception& e) {
     request.SetResponseStatus(userver::server::http::HttpStatus::kInternalServerError);
     LOG_ERROR() << "Error processing guess: " << e.what();
-    return userver::formats::json::ToString(userver::formats::json::MakeObject("error", e.what()));
+    return api::MakeError(e.what());
   }
 }
 
+void GuessHandler::WriteStatistics(userver::utils::statistics::Writer& writer) const {
+  auto timings = writer["timings"];
+  timings["parse"] = statistics_.parse.GetHistogram();
+  timings["session-lookup"] = statistics_.session_lookup.GetHistogram();
+  timings["word-lookup"] = statistics_.word_lookup.GetHistogram();
+  timings["rank"] = statistics_.rank.GetHistogram();
+  timings["serialize"] = statistics_.serialize.GetHistogram();
+
+  writer["duplicates"] = statistics_.duplicates.load(std::memory_order_relaxed);
+}
+
+userver::yaml_config::Schema GuessHandler::GetStaticConfigSchema() {
+  return userver::yaml_config::MergeSchemas<userver::server::handlers::HttpHandlerBase>(R"(
+type: object
+description: Guess handler
+additionalProperties: false
+properties:
+  auto-correct:
+    type: boolean
+    description: accept an unknown word as its closest dictionary spelling when that spelling is unambiguous
+    defaultDescription: false
+  max-correction-distance:
+    type: integer
+    description: maximum number of edits between an unknown word and a suggested spelling, 0 disables suggestions
+    defaultDescription: 1
+  suggestions-limit:
+    type: integer
+    description: maximum number of spellings suggested for an unknown word
+    defaultDescription: 3
+  compute-task-processor:
+    type: string
+    description: task processor for full vocabulary scans
+    defaultDescription: compute-task-processor
+)");
+}
+
 }  // namespace contexto
@@ -1,24 +1,57 @@
 #pragma once
 
-#include <userver/server/handlers/http_handler_base.hpp>
+#include "cors_handler_base.hpp"
+#include "statistics.hpp"
+
+#include <userver/engine/task/task_processor_fwd.hpp>
+#include <userver/utils/statistics/entry.hpp>
 
 namespace contexto {
 
+class GameEventLog;
+class GuessAnalytics;
 class SessionManager;
 class WordDictionaryComponent;
 
-class GuessHandler final : public userver::server::handlers::HttpHandlerBase {
+class GuessHandler final : public CorsHandlerBase {
 public:
   static constexpr std::string_view kName = "contexto-guess-handler";
 
   GuessHandler(const userver::components::ComponentConfig&, const userver::components::ComponentContext&);
+  ~GuessHandler() override;
+
+  static userver::yaml_config::Schema GetStaticConfigSchema();
 
-  std::string HandleRequestThrow(const userver::server::http::HttpRequest&,
-                                 userver::server::request::RequestContext&) const override;
+protected:
+  std::string HandleApiRequest(const userver::server::http::HttpRequest&,
+                               userver::server::request::RequestContext&,
+                               std::pmr::memory_resource& arena) const override;
 
 private:
+  struct Statistics {
+    statistics::LatencyHistogram parse;
+    statistics::LatencyHistogram session_lookup;
+    statistics::LatencyHistogram word_lookup;
+    statistics::LatencyHistogram rank;
+    statistics::LatencyHistogram serialize;
+    std::atomic<uint64_t> duplicates{0};  // Words the session had already guessed
+  };
+
+  void WriteStatistics(userver::utils::statistics::Writer& writer) const;
+
   SessionManager& session_manager_;
   const WordDictionaryComponent& dictionary_;
+  const GameEventLog& event_log_;
+  const GuessAnalytics& analytics_;
+  userver::engine::TaskProcessor& compute_task_processor_;
+
+  // Unknown words are answered with dictionary spellings within this many edits
+  bool auto_correct_;
+  size_t max_correction_distance_;
+  size_t suggestions_limit_;
+
+  mutable Statistics statistics_;
+  userver::utils::statistics::Entry statistics_holder_;
 };
 
 }  // namespace contexto
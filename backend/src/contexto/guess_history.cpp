@@ -0,0 +1,27 @@
+#include "guess_history.hpp"
+
+namespace contexto {
+
+namespace {
+
+constexpr auto kByWord = [](const RankedGuess& guess) { return guess.word; };
+
+}  // namespace
+
+bool GuessHistory::Add(GuessedWord word, int rank) {
+  const auto word_position = std::ranges::lower_bound(by_word_, word, {}, kByWord);
+  if (word_position != by_word_.end() && word_position->word == word) return false;
+
+  const RankedGuess guess{.rank = rank, .word = word};
+  by_word_.insert(word_position, guess);
+  by_rank_.insert(std::ranges::upper_bound(by_rank_, guess), guess);
+  return true;
+}
+
+std::optional<int> GuessHistory::FindRank(GuessedWord word) const {
+  const auto it = std::ranges::lower_bound(by_word_, word, {}, kByWord);
+  if (it == by_word_.end() || it->word != word) return std::nullopt;
+  return it->rank;
+}
+
+}  // namespace contexto
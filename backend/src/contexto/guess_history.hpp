@@ -0,0 +1,57 @@
+#pragma once
+
+#include <pch.hpp>
+
+namespace contexto {
+
+// A word as it was guessed: bare guesses are ranked by their closest POS variant, so the same embedding index
+// guessed with and without a POS tag are different guesses
+struct GuessedWord {
+  uint32_t index = 0;  // Embedding index (see WordDictionary::FindWordIndex)
+  bool has_pos = false;
+
+  auto operator<=>(const GuessedWord&) const = default;
+};
+
+struct RankedGuess {
+  int32_t rank = 0;
+  GuessedWord word;
+
+  auto operator<=>(const RankedGuess&) const = default;
+};
+
+// Guesses of one session kept in rank order, so the best guess is the front and a page of the sorted list is a
+// contiguous slice. A second array sorted by word answers "was this guessed already" with a binary search before
+// the guess is ranked. Sessions make tens to hundreds of guesses, so inserting into sorted arrays moves less
+// memory than the node allocations of a tree or a hash set would cost.
+class GuessHistory {
+public:
+  // Returns false, leaving the history unchanged, if the word was guessed before
+  bool Add(GuessedWord word, int rank);
+
+  // Rank the word got when it was guessed before
+  std::optional<int> FindRank(GuessedWord word) const;
+
+  // Closest guess so far
+  const RankedGuess* Best() const noexcept { return by_rank_.empty() ? nullptr : &by_rank_.front(); }
+
+  // Guesses at positions [offset, offset + limit) of the rank order
+  std::span<const RankedGuess> Slice(size_t offset, size_t limit) const noexcept {
+    const std::span<const RankedGuess> guesses(by_rank_);
+    offset = std::min(offset, guesses.size());
+    return guesses.subspan(offset, std::min(limit, guesses.size() - offset));
+  }
+
+  size_t Size() const noexcept { return by_rank_.size(); }
+  bool Empty() const noexcept { return by_rank_.empty(); }
+
+  size_t MemoryUsage() const noexcept {
+    return by_rank_.capacity() * sizeof(RankedGuess) + by_word_.capacity() * sizeof(RankedGuess);
+  }
+
+private:
+  std::vector<RankedGuess> by_rank_;  // Ordered by rank, then by word
+  std::vector<RankedGuess> by_word_;  // The same guesses ordered by word
+};
+
+}  // namespace contexto
@@ -0,0 +1,83 @@
+#include "guesses_handler.hpp"
+#include "api_json.hpp"
+#include "session_manager.hpp"
+#include "word_dictionary_component.hpp"
+
+#include <userver/components/component_config.hpp>
+#include <userver/components/component_context.hpp>
+#include <userver/formats/json/string_builder.hpp>
+#include <userver/logging/log.hpp>
+#include <userver/server/http/http_status.hpp>
+#include <userver/yaml_config/merge_schemas.hpp>
+
+namespace contexto {
+
+GuessesHandler::GuessesHandler(const userver::components::ComponentConfig& config,
+                               const userver::components::ComponentContext& context)
+    : CorsHandlerBase(config, context),
+      session_manager_(context.FindComponent<SessionManager>()),
+      dictionary_(context.FindComponent<WordDictionaryComponent>()),
+      max_page_size_(config["max-page-size"].As<size_t>(100)) {
+  LOG_INFO() << "GuessesHandler initialized with max_page_size=" << max_page_size_;
+}
+
+std::string GuessesHandler::HandleApiRequest(const userver::server::http::HttpRequest& request,
+                                             userver::server::request::RequestContext&,
+                                             std::pmr::memory_resource& arena) const {
+  const auto& session_id = request.GetCookie("session_id");
+  if (session_id.empty() || !session_manager_.HasSession(session_id)) {
+    request.SetResponseStatus(userver::server::http::HttpStatus::kBadRequest);
+    return api::MakeError("Invalid game session");
+  }
+
+  size_t offset = 0;
+  size_t limit = max_page_size_;
+  if (!ParseSizeArg(request.GetArg("offset"), offset) || !ParseSizeArg(request.GetArg("limit"), limit)) {
+    request.SetResponseStatus(userver::server::http::HttpStatus::kBadRequest);
+    return api::MakeError("Invalid offset or limit");
+  }
+  limit = std::min(limit, max_page_size_);
+
+  // Only the requested page is copied out of the session, into the request arena
+  std::pmr::vector<RankedGuess> guesses(limit, &arena);
+  const GuessPage page = session_manager_.GetGuesses(session_id, offset, guesses);
+
+  const auto& dictionary = dictionary_.GetDictionary();
+  userver::formats::json::StringBuilder builder;
+  {
+    const userver::formats::json::StringBuilder::ObjectGuard object_guard(builder);
+    builder.Key("total");
+    WriteToStream(static_cast<uint64_t>(page.total), builder);
+    builder.Key("offset");
+    WriteToStream(static_cast<uint64_t>(offset), builder);
+    builder.Key("guesses");
+    const userver::formats::json::StringBuilder::ArrayGuard array_guard(builder);
+    for (size_t i = 0; i < page.count; ++i) {
+      const auto& guess = guesses[i];
+      const userver::formats::json::StringBuilder::ObjectGuard guess_guard(builder);
+      builder.Key("word");
+      WriteToStream(guess.word.has_pos ? dictionary.GetWordWithEmbeddingByIndex(guess.word.index).word_with_pos
+                                       : dictionary.GetWord(guess.word.index),
+                    builder);
+      builder.Key("rank");
+      WriteToStream(static_cast<int64_t>(guess.rank), builder);
+    }
+  }
+
+  return builder.GetString();
+}
+
+userver::yaml_config::Schema GuessesHandler::GetStaticConfigSchema() {
+  return userver::yaml_config::MergeSchemas<userver::server::handlers::HttpHandlerBase>(R"(
+type: object
+description: Handler listing the guesses of the current session in rank order
+additionalProperties: false
+properties:
+  max-page-size:
+    type: integer
+    description: maximum number of guesses per page
+    defaultDescription: 100
+)");
+}
+
+}  // namespace contexto
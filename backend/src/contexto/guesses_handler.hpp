@@ -0,0 +1,30 @@
+#pragma once
+
+#include "cors_handler_base.hpp"
+
+namespace contexto {
+
+class SessionManager;
+class WordDictionaryComponent;
+
+// Pages through the guesses of the current session in rank order: GET /api/guesses?offset=&limit=
+class GuessesHandler final : public CorsHandlerBase {
+public:
+  static constexpr std::string_view kName = "contexto-guesses-handler";
+
+  GuessesHandler(const userver::components::ComponentConfig&, const userver::components::ComponentContext&);
+
+  static userver::yaml_config::Schema GetStaticConfigSchema();
+
+protected:
+  std::string HandleApiRequest(const userver::server::http::HttpRequest&,
+                               userver::server::request::RequestContext&,
+                               std::pmr::memory_resource& arena) const override;
+
+private:
+  const SessionManager& session_manager_;
+  const WordDictionaryComponent& dictionary_;
+  size_t max_page_size_;
+};
+
+}  // namespace contexto
@@ -3,10 +3,11 @@
 #include <pch.hpp>
 
 #include <Eigen/Dense>
+#include <utils/dot_product.hpp>
 
 namespace contexto::models {
 
-enum class WordType {
+enum class WordType : uint8_t {
   kUnknown = 0,
   kAdjective,
   kAdposition,
@@ -64,6 +65,46 @@ static constexpr WordType GetWordTypeFromPOS(std::string_view pos_tag) noexcept
   return WordType::kUnknown;
 }
 
+static constexpr uint32_t WordTypeBit(WordType type) noexcept { return 1u << static_cast<uint32_t>(type); }
+
+// A word with an optional POS tag split into its parts
+struct ParsedWord {
+  std::string_view word;
+  WordType type = WordType::kUnknown;
+  size_t char_count = 0;  // Code points in word
+  bool has_pos = false;
+};
+
+// Splits off a known POS tag and counts the code points of the bare word in a single pass over the bytes.
+// Words whose last '_' isn't followed by a known tag are bare words.
+static constexpr ParsedWord ParseWordWithPOS(std::string_view word_with_pos) noexcept {
+  size_t separator = std::string_view::npos;
+  size_t char_count = 0;
+  size_t chars_before_separator = 0;
+
+  for (size_t i = 0; i < word_with_pos.size(); ++i) {
+    const auto byte = static_cast<unsigned char>(word_with_pos[i]);
+    if (byte == '_') {
+      separator = i;
+      chars_before_separator = char_count;
+    }
+    // Continuation bytes don't start a code point
+    if ((byte & 0xC0) != 0x80) ++char_count;
+  }
+
+  if (separator != std::string_view::npos) {
+    const WordType type = GetWordTypeFromPOS(word_with_pos.substr(separator + 1));
+    if (type != WordType::kUnknown) {
+      return {.word = word_with_pos.substr(0, separator),
+              .type = type,
+              .char_count = chars_before_separator,
+              .has_pos = true};
+    }
+  }
+
+  return {.word = word_with_pos, .char_count = char_count};
+}
+
 static constexpr std::string_view GetWordFromWordWithPOS(std::string_view word_with_pos) noexcept {
   if (word_with_pos.size() < 4) return {};
   const size_t pos_separator = word_with_pos.find_last_of('_');
@@ -152,9 +193,15 @@ static inline std::string GetWordWithPOS(std::string word, WordType word_type) n
   return word;
 }
 
+// One unit-length embedding per row, rows of a word's POS variants are adjacent
+using EmbeddingMatrix = Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
 struct DictionaryWord {
-  std::string word_with_pos;
-  Eigen::VectorXf embedding;
+  std::string_view word_with_pos;    // Into the word arena of the owning dictionary
+  std::span<const float> embedding;  // Row of the embedding matrix of the owning dictionary
+  // Position among the loaded words in embedding file order, 0 is the most frequent word. Filtered lines are
+  // skipped, so this is not the line number in the file.
+  uint32_t frequency_rank = 0;
 
   std::string_view GetWord() const noexcept { return GetWordFromWordWithPOS(word_with_pos); }
 
@@ -168,7 +215,9 @@ struct DictionaryWord {
     return WordType::kUnknown;
   }
 
-  float CalculateSimilarity(const DictionaryWord& other) const { return embedding.dot(other.embedding); }
+  float CalculateSimilarity(const DictionaryWord& other) const {
+    return utils::simd::Dot(embedding.data(), other.embedding.data(), embedding.size());
+  }
 };
 
 }  // namespace contexto::models
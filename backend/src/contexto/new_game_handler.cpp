@@ -1,9 +1,13 @@
 #include "new_game_handler.hpp"
+#include "api_json.hpp"
+#include "daily_puzzle_component.hpp"
+#include "game_event_log.hpp"
+#include "game_pool_component.hpp"
 #include "session_manager.hpp"
+#include "target_difficulty_component.hpp"
 #include "word_dictionary_component.hpp"
 
 #include <userver/components/component_context.hpp>
-#include <userver/formats/json.hpp>
 #include <userver/logging/log.hpp>
 #include <userver/server/http/http_status.hpp>
 #include <userver/utils/uuid4.hpp>
@@ -12,34 +16,47 @@ namespace contexto {
 
 NewGameHandler::NewGameHandler(const userver::components::ComponentConfig& config,
                                const userver::components::ComponentContext& context)
-    : HttpHandlerBase(config, context),
+    : CorsHandlerBase(config, context),
       session_manager_(context.FindComponent<SessionManager>()),
-      dictionary_(context.FindComponent<WordDictionaryComponent>()) {
+      dictionary_(context.FindComponent<WordDictionaryComponent>()),
+      daily_puzzle_(context.FindComponent<DailyPuzzleComponent>()),
+      game_pool_(context.FindComponent<GamePoolComponent>()),
+      difficulty_(context.FindComponent<TargetDifficultyComponent>()),
+      event_log_(context.FindComponent<GameEventLog>()) {
   LOG_INFO() << "NewGameHandler initialized";
 }
 
-std::string NewGameHandler::HandleRequestThrow(const userver::server::http::HttpRequest& request,
-                                               userver::server::request::RequestContext&) const {
-  auto& http_response = request.GetHttpResponse();
-
-  // Set proper CORS headers
-  const auto& origin = request.GetHeader("Origin");
-  if (!origin.empty()) {
-    http_response.SetHeader(std::string_view("Access-Control-Allow-Origin"), origin);
-  } else {
-    http_response.SetHeader(std::string_view("Access-Control-Allow-Origin"), "*");
-  }
+std::string NewGameHandler::HandleApiRequest(const userver::server::http::HttpRequest& request,
+                                             userver::server::request::RequestContext&,
+                                             std::pmr::memory_resource& arena) const {
+  try {
+    // {"mode": "daily"} joins the shared word of the day, "private" or no mode starts a private game.
+    // {"difficulty": "<tier>"} draws the target of a private game from a difficulty tier.
+    static constexpr std::array<std::string_view, 2> kFields = {"mode", "difficulty"};
+    std::array fields = {std::pmr::string(&arena), std::pmr::string(&arena)};
+    auto& [mode, difficulty] = fields;
+    if (const auto& body = request.RequestBody(); !body.empty()) {
+      try {
+        api::ParseStringFields(body, kFields, fields);
+      } catch (const std::exception& e) {
+        request.SetResponseStatus(userver::server::http::HttpStatus::kBadRequest);
+        LOG_ERROR() << "Invalid JSON: " << e.what();
+        return api::MakeError("Invalid JSON format");
+      }
+    }
 
-  http_response.SetHeader(std::string_view("Access-Control-Allow-Methods"), "GET, POST, OPTIONS");
-  http_response.SetHeader(std::string_view("Access-Control-Allow-Headers"), "Content-Type, X-Requested-With");
-  http_response.SetHeader(std::string_view("Access-Control-Allow-Credentials"), "true");
+    // A misspelled mode would otherwise quietly start a private game
+    if (!mode.empty() && mode != "daily" && mode != "private") {
+      request.SetResponseStatus(userver::server::http::HttpStatus::kBadRequest);
+      return api::MakeError("Unknown mode");
+    }
 
-  if (request.GetMethod() == userver::server::http::HttpMethod::kOptions) {
-    request.SetResponseStatus(userver::server::http::HttpStatus::kOk);
-    return "";
-  }
+    // Everyone shares the daily word, so it has no difficulty of its own to pick
+    if (mode == "daily" && !difficulty.empty()) {
+      request.SetResponseStatus(userver::server::http::HttpStatus::kBadRequest);
+      return api::MakeError("Difficulty cannot be combined with the daily mode");
+    }
 
-  try {
     std::string session_id;
     {
       const auto& cookie = request.GetCookie("session_id");
@@ -48,35 +65,105 @@ std::string NewGameHandler::HandleRequestThrow(const userver::server::http::Http
         // Set the cookie explicitly with path and SameSite attributes
         auto& response = request.GetHttpResponse();
         response.SetCookie(userver::server::http::Cookie("session_id", session_id));
-        LOG_INFO() << "Created new session ID: " << session_id;
       } else {
         session_id = cookie;
-        LOG_INFO() << "Using existing session ID: " << session_id;
       }
     }
 
+    if (mode == "daily") {
+      auto daily = daily_puzzle_.GetToday();
+      if (!daily) {
+        request.SetResponseStatus(userver::server::http::HttpStatus::kServiceUnavailable);
+        LOG_ERROR() << "Daily puzzle is not available";
+        return api::MakeError("Daily puzzle is not available - please try again later");
+      }
+
+      PushNewGameEvent(session_id, daily->ranks->GetTarget(), kGameEventDaily);
+      if (event_log_.ShouldLogSample()) {
+        LOG_INFO() << "Daily game " << daily->date_string << " started with session " << session_id;
+      }
+
+      session_manager_.SetTargetWord(session_id, daily->ranks->GetTarget().word_with_pos, daily->ranks);
+      return api::MakeNewGameResponse(session_id, daily->date_string);
+    }
+
+    if (!difficulty.empty()) {
+      const auto tier = difficulty_.FindTier(difficulty);
+      if (!tier) {
+        request.SetResponseStatus(userver::server::http::HttpStatus::kBadRequest);
+        return api::MakeError("Unknown difficulty");
+      }
+
+      if (const models::DictionaryWord* target_word = difficulty_.GenerateTargetWord(*tier)) {
+        PushNewGameEvent(session_id, *target_word, kGameEventTiered);
+        if (event_log_.ShouldLogSample()) {
+          LOG_INFO() << "New " << difficulty << " game created with session " << session_id << " and target word: '"
+                     << target_word->word_with_pos << "'";
+        }
+
+        // Pooled games are untiered, so a tiered game is ranked on the fly
+        session_manager_.SetTargetWord(session_id, target_word->word_with_pos);
+        return api::MakeNewGameResponse(session_id, {}, difficulty);
+      }
+
+      if (!difficulty_.HasFailed()) {
+        request.SetResponseStatus(userver::server::http::HttpStatus::kServiceUnavailable);
+        LOG_WARNING() << "Difficulty tiers are not ready yet";
+        return api::MakeError("Difficulty levels are not available yet - please try again later");
+      }
+
+      // Tiers will never be ready, an untiered game is better than refusing every tiered one. The response has
+      // no difficulty field, so the client can tell.
+      if (event_log_.ShouldLogSample()) {
+        LOG_WARNING() << "Difficulty tiers are unavailable, starting an untiered game for session " << session_id;
+      }
+    }
+
+    // A prepared game costs a queue pop, an empty pool falls back to ranking guesses on the fly
+    if (auto ranks = game_pool_.TryPop()) {
+      PushNewGameEvent(session_id, ranks->GetTarget(), kGameEventPooled);
+      if (event_log_.ShouldLogSample()) {
+        LOG_INFO() << "New game created with session " << session_id << " and target word: '"
+                   << ranks->GetTarget().word_with_pos << "' from the game pool";
+      }
+      session_manager_.SetTargetWord(session_id, ranks->GetTarget().word_with_pos, std::move(ranks));
+      return api::MakeNewGameResponse(session_id);
+    }
+
     const models::DictionaryWord* target_word = dictionary_.GenerateNewTargetWord();
     if (!target_word) {
       request.SetResponseStatus(userver::server::http::HttpStatus::kInternalServerError);
       LOG_ERROR() << "Failed to generate target word";
-      return userver::formats::json::ToString(
-          userver::formats::json::MakeObject("error", "Could not create game - please try again later"));
+      return api::MakeError("Could not create game - please try again later");
     }
 
-    LOG_INFO() << "New game created with session " << session_id << " and target word: '" << target_word->word_with_pos
-               << "'";
+    PushNewGameEvent(session_id, *target_word, 0);
+    if (event_log_.ShouldLogSample()) {
+      LOG_INFO() << "New game created with session " << session_id << " and target word: '"
+                 << target_word->word_with_pos << "'";
+    }
 
     session_manager_.SetTargetWord(session_id, target_word->word_with_pos);
 
-    const auto response = userver::formats::json::MakeObject("success", true, "session_id", session_id);
-
-    return userver::formats::json::ToString(response);
+    return api::MakeNewGameResponse(session_id);
 
   } catch (const std::exception& e) {
     request.SetResponseStatus(userver::server::http::HttpStatus::kInternalServerError);
     LOG_ERROR() << "Error creating new game: " << e.what();
-    return userver::formats::json::ToString(userver::formats::json::MakeObject("error", e.what()));
+    return api::MakeError(e.what());
   }
 }
 
+void NewGameHandler::PushNewGameEvent(std::string_view session_id, const models::DictionaryWord& target,
+                                      uint8_t flags) const {
+  const auto target_index = dictionary_.GetDictionary().FindWordIndex(target.word_with_pos);
+  event_log_.Push(GameEvent{
+      .timestamp_ns = GameEventLog::Now(),
+      .session = GameEventLog::HashSession(session_id),
+      .word_index = static_cast<uint32_t>(target_index.value_or(0)),
+      .type = GameEventType::kNewGame,
+      .flags = flags,
+  });
+}
+
 }  // namespace contexto
@@ -1,24 +1,40 @@
 #pragma once
 
-#include <userver/server/handlers/http_handler_base.hpp>
+#include "cors_handler_base.hpp"
 
 namespace contexto {
 
+namespace models {
+struct DictionaryWord;
+}  // namespace models
+
+class DailyPuzzleComponent;
+class GameEventLog;
+class GamePoolComponent;
 class SessionManager;
+class TargetDifficultyComponent;
 class WordDictionaryComponent;
 
-class NewGameHandler final : public userver::server::handlers::HttpHandlerBase {
+class NewGameHandler final : public CorsHandlerBase {
 public:
   static constexpr std::string_view kName = "contexto-new-game-handler";
 
   NewGameHandler(const userver::components::ComponentConfig&, const userver::components::ComponentContext&);
 
-  std::string HandleRequestThrow(const userver::server::http::HttpRequest&,
-                                 userver::server::request::RequestContext&) const override;
+protected:
+  std::string HandleApiRequest(const userver::server::http::HttpRequest&,
+                               userver::server::request::RequestContext&,
+                               std::pmr::memory_resource& arena) const override;
 
 private:
+  void PushNewGameEvent(std::string_view session_id, const models::DictionaryWord& target, uint8_t flags) const;
+
   SessionManager& session_manager_;
   const WordDictionaryComponent& dictionary_;
+  const DailyPuzzleComponent& daily_puzzle_;
+  const GamePoolComponent& game_pool_;
+  const TargetDifficultyComponent& difficulty_;
+  const GameEventLog& event_log_;
 };
 
 }  // namespace contexto
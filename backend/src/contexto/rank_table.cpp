@@ -0,0 +1,60 @@
+#include "rank_table.hpp"
+#include "cooperative_yield.hpp"
+#include "word_dictionary_component.hpp"
+
+namespace contexto {
+
+RankTable RankTable::Build(const WordDictionaryComponent& dictionary, const models::DictionaryWord& target) {
+  static_assert(WordDictionaryComponent::kMaxRank <= std::numeric_limits<int16_t>::max());
+
+  RankTable table(dictionary, target);
+  const WordDictionary& words = dictionary.GetDictionary();
+  const size_t size = words.EmbeddingsSize();
+  table.pos_ranks_.assign(size, kNoRank);
+  table.word_ranks_.assign(size, kNoRank);
+
+  const auto target_index = words.FindWordIndex(target.word_with_pos);
+  if (!target_index) return table;
+
+  // The same rank function as for games without a table, so both rank a guess identically.
+  // A table takes a full vocabulary scan, other tasks on the same task processor still get to run.
+  CooperativeYield yield;
+  for (size_t i = 0; i < size; ++i, yield.Tick()) {
+    table.pos_ranks_[i] = static_cast<int16_t>(dictionary.CalculateRank(i, true, *target_index));
+
+    // Bare words are ranked once, at their first POS variant
+    const VariantRange variants = words.GetPOSVariants(i);
+    if (variants.begin != i) continue;
+
+    const auto word_rank = static_cast<int16_t>(dictionary.CalculateRank(i, false, *target_index));
+    std::fill(table.word_ranks_.begin() + variants.begin, table.word_ranks_.begin() + variants.end, word_rank);
+    if (words.IsCanonicalSpelling(i)) table.closest_words_.push_back(static_cast<uint32_t>(i));
+  }
+
+  // Only the head of the order is ever shown, so it's sorted once here and the rest dropped.
+  // Indices follow word frequency, which breaks the ties of the coarse ranks.
+  const auto closer = [&table](uint32_t lhs, uint32_t rhs) {
+    return std::pair(table.word_ranks_[lhs], lhs) < std::pair(table.word_ranks_[rhs], rhs);
+  };
+  auto& closest = table.closest_words_;
+  const size_t closest_size = std::min(closest.size(), kClosestWords);
+  std::ranges::partial_sort(closest, closest.begin() + static_cast<std::ptrdiff_t>(closest_size), closer);
+  closest.resize(closest_size);
+  closest.shrink_to_fit();
+
+  return table;
+}
+
+std::optional<int> RankTable::GetRank(std::string_view canonical_word) const {
+  const auto index = dictionary_->GetDictionary().FindWordIndex(canonical_word);
+  if (!index) return std::nullopt;
+  return GetRank(*index, models::WordHasPOS(canonical_word));
+}
+
+std::optional<int> RankTable::GetRank(size_t word_index, bool has_pos) const {
+  const int16_t rank = has_pos ? pos_ranks_[word_index] : word_ranks_[word_index];
+  if (rank == kNoRank) return std::nullopt;
+  return rank;
+}
+
+}  // namespace contexto
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <contexto/models/dictionary_word.hpp>
+
+namespace contexto {
+
+class WordDictionaryComponent;
+
+// Rank of every guessable word against one target, computed once per game ahead of time and shared read-only
+// by the sessions playing it. Ranks are indexed by embedding index, so a guess costs one array read.
+class RankTable {
+public:
+  // Length of the closest words list kept with every table
+  static constexpr size_t kClosestWords = 1000;
+
+  static RankTable Build(const WordDictionaryComponent& dictionary, const models::DictionaryWord& target);
+
+  // Rank of a canonical spelling (see WordDictionary::FindCanonicalWord), nullopt for unknown words
+  std::optional<int> GetRank(std::string_view canonical_word) const;
+
+  // Same for an index already resolved with WordDictionary::FindWordIndex
+  std::optional<int> GetRank(size_t word_index, bool has_pos) const;
+
+  // Embedding indices of the bare words closest to the target in rank order, more frequent words first among
+  // equal ranks. Every word is listed once, by its canonical spelling.
+  std::span<const uint32_t> GetClosestWords() const noexcept { return closest_words_; }
+
+  const models::DictionaryWord& GetTarget() const noexcept { return *target_; }
+  size_t MemoryUsage() const noexcept {
+    return (pos_ranks_.capacity() + word_ranks_.capacity()) * sizeof(int16_t) +
+           closest_words_.capacity() * sizeof(uint32_t);
+  }
+
+private:
+  RankTable(const WordDictionaryComponent& dictionary, const models::DictionaryWord& target)
+      : dictionary_(&dictionary), target_(&target) {}
+
+  static constexpr int16_t kNoRank = -1;
+
+  const WordDictionaryComponent* dictionary_;
+  const models::DictionaryWord* target_;
+
+  // Guesses with an explicit POS tag rank by that variant, bare guesses by their closest variant and
+  // share one rank across all variants
+  std::vector<int16_t> pos_ranks_;
+  std::vector<int16_t> word_ranks_;
+  std::vector<uint32_t> closest_words_;
+};
+
+}  // namespace contexto
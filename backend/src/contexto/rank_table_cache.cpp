@@ -0,0 +1,70 @@
+#include "rank_table_cache.hpp"
+#include "word_dictionary_component.hpp"
+
+#include <userver/components/component_config.hpp>
+#include <userver/components/component_context.hpp>
+#include <userver/components/statistics_storage.hpp>
+#include <userver/logging/log.hpp>
+#include <userver/utils/async.hpp>
+#include <userver/utils/statistics/writer.hpp>
+#include <userver/yaml_config/merge_schemas.hpp>
+
+namespace contexto {
+
+RankTableCache::RankTableCache(const userver::components::ComponentConfig& config,
+                               const userver::components::ComponentContext& context)
+    : LoggableComponentBase(config, context),
+      dictionary_(context.FindComponent<WordDictionaryComponent>()),
+      compute_task_processor_(
+          context.GetTaskProcessor(config["task-processor"].As<std::string>("compute-task-processor"))),
+      tables_(config["capacity"].As<size_t>(64)) {
+  statistics_holder_ =
+      context.FindComponent<userver::components::StatisticsStorage>().GetStorage().RegisterWriter(
+          "contexto.rank-tables", [this](userver::utils::statistics::Writer& writer) { WriteStatistics(writer); });
+
+  LOG_INFO() << "RankTableCache initialized with capacity=" << tables_.Capacity();
+}
+
+RankTableCache::~RankTableCache() { statistics_holder_.Unregister(); }
+
+std::shared_ptr<const RankTable> RankTableCache::Get(const models::DictionaryWord& target) const {
+  const auto index = dictionary_.GetDictionary().FindWordIndex(target.word_with_pos);
+  if (!index) {
+    LOG_ERROR() << "Target word has no embedding index";
+    return nullptr;
+  }
+
+  return tables_.Get(*index, [this, &target] {
+    return userver::utils::SharedAsync(compute_task_processor_, "rank-table-build", [this, &target] {
+      return std::make_shared<const RankTable>(RankTable::Build(dictionary_, target));
+    });
+  });
+}
+
+void RankTableCache::WriteStatistics(userver::utils::statistics::Writer& writer) const {
+  writer["cached"] = tables_.Size();
+  writer["in-flight"] = tables_.InFlightSize();
+  writer["hits"] = tables_.Hits();
+  writer["builds"] = tables_.Builds();
+  writer["coalesced"] = tables_.Coalesced();
+  writer["failed-builds"] = tables_.Failures();
+}
+
+userver::yaml_config::Schema RankTableCache::GetStaticConfigSchema() {
+  return userver::yaml_config::MergeSchemas<userver::components::LoggableComponentBase>(R"(
+type: object
+description: Cache of per-target rank tables with coalesced builds
+additionalProperties: false
+properties:
+  capacity:
+    type: integer
+    description: maximum number of cached tables, each holds 4 bytes per embedding
+    defaultDescription: 64
+  task-processor:
+    type: string
+    description: task processor the tables are built on
+    defaultDescription: compute-task-processor
+)");
+}
+
+}  // namespace contexto
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "coalescing_cache.hpp"
+#include "rank_table.hpp"
+
+#include <userver/components/loggable_component_base.hpp>
+#include <userver/engine/task/task_processor_fwd.hpp>
+#include <userver/utils/statistics/entry.hpp>
+
+namespace contexto {
+
+class WordDictionaryComponent;
+
+// Rank tables of recently played targets. Concurrent requests for a target that is being built wait for the
+// same build instead of starting their own, so a burst on one target costs one computation. A build that throws
+// is retried by the next request for its target.
+class RankTableCache final : public userver::components::LoggableComponentBase {
+public:
+  static constexpr std::string_view kName = "rank-table-cache";
+
+  RankTableCache(const userver::components::ComponentConfig& config,
+                 const userver::components::ComponentContext& context);
+  ~RankTableCache() override;
+
+  // Cached table of the target, built on the compute task processor on a miss. Waits for the build and rethrows
+  // its exception.
+  std::shared_ptr<const RankTable> Get(const models::DictionaryWord& target) const;
+
+  static userver::yaml_config::Schema GetStaticConfigSchema();
+
+private:
+  void WriteStatistics(userver::utils::statistics::Writer& writer) const;
+
+  const WordDictionaryComponent& dictionary_;
+  userver::engine::TaskProcessor& compute_task_processor_;
+
+  // Keyed by the embedding index of the target
+  mutable CoalescingCache<size_t, std::shared_ptr<const RankTable>> tables_;
+  userver::utils::statistics::Entry statistics_holder_;
+};
+
+}  // namespace contexto
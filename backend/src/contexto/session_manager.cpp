@@ -1,7 +1,10 @@
 #include "session_manager.hpp"
 
 #include <userver/components/component_config.hpp>
+#include <userver/components/component_context.hpp>
+#include <userver/components/statistics_storage.hpp>
 #include <userver/logging/log.hpp>
+#include <userver/utils/statistics/writer.hpp>
 #include <userver/yaml_config/merge_schemas.hpp>
 
 namespace contexto {
@@ -10,19 +13,32 @@ SessionManager::SessionManager(const userver::components::ComponentConfig& confi
                                const userver::components::ComponentContext& context)
     : LoggableComponentBase(config, context),
       max_sessions_(config.HasMember("max-sessions") ? config["max-sessions"].As<size_t>() : 10000) {
+  statistics_holder_ =
+      context.FindComponent<userver::components::StatisticsStorage>().GetStorage().RegisterWriter(
+          "contexto.sessions", [this](userver::utils::statistics::Writer& writer) { WriteStatistics(writer); });
+
   LOG_INFO() << "SessionManager initialized with max_sessions=" << max_sessions_;
 }
 
+SessionManager::~SessionManager() { statistics_holder_.Unregister(); }
+
 void SessionManager::CleanupSessions() {
   std::lock_guard lock(mutex_);
   if (!game_sessions_.empty()) {
     const auto it = game_sessions_.begin();
     LOG_INFO() << "Cleaning up session: " << it->first;
-    game_sessions_.erase(it);
+    EraseSession(it);
+    evicted_sessions_.fetch_add(1, std::memory_order_relaxed);
   }
 }
 
-void SessionManager::SetTargetWord(const std::string& session_id, std::string_view word_with_pos) {
+void SessionManager::EraseSession(Sessions::iterator it) {
+  stored_guesses_.fetch_sub(it->second.guesses.Size(), std::memory_order_relaxed);
+  game_sessions_.erase(it);
+}
+
+void SessionManager::SetTargetWord(const std::string& session_id, std::string_view word_with_pos,
+                                   std::shared_ptr<const RankTable> ranks) {
   std::unique_lock lock(mutex_);
   if (game_sessions_.size() >= max_sessions_) {
     LOG_WARNING() << "Session limit reached, cleaning up old sessions";
@@ -31,36 +47,46 @@ void SessionManager::SetTargetWord(const std::string& session_id, std::string_vi
     mutex_.lock();
   }
 
-  game_sessions_[session_id] = GameSession{.target_word_with_pos = word_with_pos, .is_game_over = false};
+  // A new game in the same session starts with an empty history
+  auto& session = game_sessions_[session_id];
+  stored_guesses_.fetch_sub(session.guesses.Size(), std::memory_order_relaxed);
+  session = GameSession{
+      .target_word_with_pos = word_with_pos, .is_game_over = false, .ranks = std::move(ranks), .guesses = {}};
 }
 
-std::vector<std::string_view> SessionManager::GetGuessedWords(const std::string& session_id) const {
-  std::vector<std::string_view> words;
+GuessPage SessionManager::GetGuesses(const std::string& session_id, size_t offset, std::span<RankedGuess> out) const {
   std::shared_lock lock(mutex_);
 
-  const auto it = session_guesses_.find(session_id);
-  if (it == session_guesses_.end()) return words;
-  words.reserve(it->second.size());
-  for (const auto& guess : it->second) {
-    words.push_back(guess.word);
-  }
-  return words;
+  const auto it = game_sessions_.find(session_id);
+  if (it == game_sessions_.end()) return {};
+
+  const auto& guesses = it->second.guesses;
+  const auto slice = guesses.Slice(offset, out.size());
+  std::ranges::copy(slice, out.begin());
+  return {.total = guesses.Size(), .count = slice.size()};
 }
 
-std::optional<GuessInfo> SessionManager::GetClosestGuess(const std::string& session_id) const {
+std::optional<RankedGuess> SessionManager::GetClosestGuess(const std::string& session_id) const {
   std::shared_lock lock(mutex_);
 
-  const auto it = session_guesses_.find(session_id);
-  const auto& guesses = it->second;
-  if (it == session_guesses_.end() || guesses.empty()) {
-    return std::nullopt;
-  }
+  const auto it = game_sessions_.find(session_id);
+  if (it == game_sessions_.end()) return std::nullopt;
 
-  // Find the guess with the lowest rank (closest to target)
-  const auto closest =
-      std::ranges::min_element(guesses, [](const GuessInfo& lhs, const GuessInfo& rhs) { return lhs.rank < rhs.rank; });
+  const RankedGuess* best = it->second.guesses.Best();
+  if (!best) return std::nullopt;
+  return *best;
+}
+
+void SessionManager::WriteStatistics(userver::utils::statistics::Writer& writer) const {
+  size_t active_sessions = 0;
+  {
+    std::shared_lock lock(mutex_);
+    active_sessions = game_sessions_.size();
+  }
 
-  return *closest;
+  writer["active"] = active_sessions;
+  writer["stored-guesses"] = stored_guesses_.load(std::memory_order_relaxed);
+  writer["evicted"] = evicted_sessions_.load(std::memory_order_relaxed);
 }
 
 userver::yaml_config::Schema SessionManager::GetStaticConfigSchema() {
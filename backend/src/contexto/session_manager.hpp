@@ -2,17 +2,31 @@
 
 #include <userver/components/loggable_component_base.hpp>
 #include <userver/engine/shared_mutex.hpp>
+#include <userver/utils/statistics/entry.hpp>
+
+#include "guess_history.hpp"
 
 namespace contexto {
 
-struct GuessInfo {
-  std::string_view word;
-  int rank = -1;
-};
+class RankTable;
 
 struct GameSession {
   std::string_view target_word_with_pos;
   bool is_game_over = false;
+  std::shared_ptr<const RankTable> ranks;  // Precomputed ranks of the target, null if guesses are ranked on the fly
+  GuessHistory guesses;                    // Dropped together with the session
+};
+
+// Outcome of recording a guess
+struct AddedGuess {
+  size_t guess_number = 0;            // Guesses of the session including this one, 0 if there is no such session
+  std::optional<int> previous_rank;  // Set if the session guessed the word before, nothing is stored then
+};
+
+// One page of a session's guesses in rank order
+struct GuessPage {
+  size_t total = 0;  // Guesses of the session, not just of this page
+  size_t count = 0;  // Guesses written to the output
 };
 
 class SessionManager final : public userver::components::LoggableComponentBase {
@@ -20,10 +34,12 @@ public:
   static constexpr std::string_view kName = "session-manager";
 
   SessionManager(const userver::components::ComponentConfig&, const userver::components::ComponentContext&);
+  ~SessionManager() override;
 
   void RemoveSession(const std::string& session_id) {
     std::lock_guard lock(mutex_);
-    game_sessions_.erase(session_id);
+    const auto it = game_sessions_.find(session_id);
+    if (it != game_sessions_.end()) EraseSession(it);
   }
 
   void CleanupSessions();
@@ -33,14 +49,31 @@ public:
     return game_sessions_.find(session_id) != game_sessions_.end();
   }
 
-  void AddGuess(const std::string& session_id, std::string_view word, int rank) {
+  // The duplicate check and the insert are one step, so of concurrent submissions of a word only one is stored
+  AddedGuess AddGuess(const std::string& session_id, GuessedWord word, int rank) {
     std::lock_guard lock(mutex_);
-    auto& guesses = session_guesses_[session_id];
-    GuessInfo info{.word = word, .rank = rank};
-    guesses.push_back(info);
+    const auto it = game_sessions_.find(session_id);
+    if (it == game_sessions_.end()) return {};
+
+    auto& guesses = it->second.guesses;
+    if (const auto previous_rank = guesses.FindRank(word)) {
+      return {.guess_number = guesses.Size(), .previous_rank = previous_rank};
+    }
+    guesses.Add(word, rank);
+    stored_guesses_.fetch_add(1, std::memory_order_relaxed);
+    return {.guess_number = guesses.Size(), .previous_rank = std::nullopt};
   }
 
-  void SetTargetWord(const std::string& session_id, std::string_view word_with_pos);
+  // Rank the word got if the session guessed it before
+  std::optional<int> FindGuessRank(const std::string& session_id, GuessedWord word) const {
+    std::shared_lock lock(mutex_);
+    const auto it = game_sessions_.find(session_id);
+    if (it == game_sessions_.end()) return std::nullopt;
+    return it->second.guesses.FindRank(word);
+  }
+
+  void SetTargetWord(const std::string& session_id, std::string_view word_with_pos,
+                     std::shared_ptr<const RankTable> ranks = nullptr);
 
   void MarkGameOver(const std::string& session_id) {
     std::lock_guard lock(mutex_);
@@ -57,6 +90,13 @@ public:
     return it->second.target_word_with_pos;
   }
 
+  std::shared_ptr<const RankTable> GetRankTable(const std::string& session_id) const {
+    std::shared_lock lock(mutex_);
+    const auto it = game_sessions_.find(session_id);
+    if (it == game_sessions_.end()) return nullptr;
+    return it->second.ranks;
+  }
+
   bool IsGameOver(const std::string& session_id) const {
     std::shared_lock lock(mutex_);
     const auto it = game_sessions_.find(session_id);
@@ -64,18 +104,37 @@ public:
     return it->second.is_game_over;
   }
 
-  std::vector<std::string_view> GetGuessedWords(const std::string& session_id) const;
+  // Given up or won
+  bool IsFinished(const std::string& session_id) const {
+    std::shared_lock lock(mutex_);
+    const auto it = game_sessions_.find(session_id);
+    if (it == game_sessions_.end()) return false;
+    const RankedGuess* best = it->second.guesses.Best();
+    return it->second.is_game_over || (best && best->rank == 1);
+  }
+
+  // Copies the guesses at positions [offset, offset + out.size()) of the rank order into out
+  GuessPage GetGuesses(const std::string& session_id, size_t offset, std::span<RankedGuess> out) const;
 
-  std::optional<GuessInfo> GetClosestGuess(const std::string& session_id) const;
+  std::optional<RankedGuess> GetClosestGuess(const std::string& session_id) const;
 
   static userver::yaml_config::Schema GetStaticConfigSchema();
 
 private:
+  using Sessions = std::unordered_map<std::string, GameSession>;
+
+  // Callers hold the mutex exclusively
+  void EraseSession(Sessions::iterator it);
+
+  void WriteStatistics(userver::utils::statistics::Writer& writer) const;
+
   mutable userver::engine::SharedMutex mutex_;
-  std::unordered_map<std::string, GameSession> game_sessions_;
+  Sessions game_sessions_;
   size_t max_sessions_ = 0;
 
-  std::unordered_map<std::string, std::vector<GuessInfo>> session_guesses_;
+  std::atomic<size_t> stored_guesses_ = 0;  // Over the sessions currently stored
+  std::atomic<size_t> evicted_sessions_ = 0;
+  userver::utils::statistics::Entry statistics_holder_;
 };
 
 }  // namespace contexto
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <pch.hpp>
+
+#include <userver/utils/statistics/histogram.hpp>
+#include <userver/utils/statistics/writer.hpp>
+
+#include "utils/request_arena.hpp"
+
+namespace contexto::statistics {
+
+// Upper bounds of latency histogram buckets, in microseconds
+inline constexpr std::array<double, 14> kLatencyBoundsUs = {1,   2,    5,    10,   25,    50,    100,
+                                                            250, 500, 1000, 2500, 10000, 50000, 250000};
+
+class LatencyHistogram final {
+public:
+  LatencyHistogram() : histogram_(kLatencyBoundsUs) {}
+
+  void Account(std::chrono::steady_clock::duration duration) noexcept {
+    histogram_.Account(std::chrono::duration<double, std::micro>(duration).count());
+  }
+
+  const userver::utils::statistics::Histogram& GetHistogram() const noexcept { return histogram_; }
+
+private:
+  userver::utils::statistics::Histogram histogram_;
+};
+
+// Accounts the time elapsed since construction into a histogram on Stop() or destruction
+class ScopeLatency final {
+public:
+  explicit ScopeLatency(LatencyHistogram& histogram) noexcept
+      : histogram_(&histogram), start_(std::chrono::steady_clock::now()) {}
+
+  ScopeLatency(const ScopeLatency&) = delete;
+  ScopeLatency(ScopeLatency&&) = delete;
+  ~ScopeLatency() { Stop(); }
+
+  void Stop() noexcept {
+    if (!histogram_) return;
+    histogram_->Account(std::chrono::steady_clock::now() - start_);
+    histogram_ = nullptr;
+  }
+
+  ScopeLatency& operator=(const ScopeLatency&) = delete;
+  ScopeLatency& operator=(ScopeLatency&&) = delete;
+
+private:
+  LatencyHistogram* histogram_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+// Totals over the request arenas of one handler; dividing by requests gives the per-request figures
+class ArenaCounters final {
+public:
+  void Account(const utils::RequestArena& arena) noexcept {
+    requests_.fetch_add(1, std::memory_order_relaxed);
+    allocations_.fetch_add(arena.Allocations(), std::memory_order_relaxed);
+    bytes_.fetch_add(arena.AllocatedBytes(), std::memory_order_relaxed);
+    upstream_allocations_.fetch_add(arena.UpstreamAllocations(), std::memory_order_relaxed);
+  }
+
+  void Write(userver::utils::statistics::Writer& writer) const {
+    writer["requests"] = requests_.load(std::memory_order_relaxed);
+    writer["allocations"] = allocations_.load(std::memory_order_relaxed);
+    writer["bytes"] = bytes_.load(std::memory_order_relaxed);
+    writer["upstream-allocations"] = upstream_allocations_.load(std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<uint64_t> requests_{0};
+  std::atomic<uint64_t> allocations_{0};
+  std::atomic<uint64_t> bytes_{0};
+  std::atomic<uint64_t> upstream_allocations_{0};  // Heap blocks requested after a slab ran out
+};
+
+}  // namespace contexto::statistics
@@ -0,0 +1,402 @@
+#include "target_difficulty_component.hpp"
+#include "cooperative_yield.hpp"
+#include "dictionary_filter_component.hpp"
+#include "word_dictionary_component.hpp"
+
+#include <utils/fnv1a.hpp>
+
+#include <userver/components/component_config.hpp>
+#include <userver/components/component_context.hpp>
+#include <userver/components/statistics_storage.hpp>
+#include <userver/engine/sleep.hpp>
+#include <userver/engine/task/cancel.hpp>
+#include <userver/logging/log.hpp>
+#include <userver/utils/async.hpp>
+#include <userver/utils/statistics/writer.hpp>
+#include <userver/yaml_config/merge_schemas.hpp>
+
+namespace contexto {
+
+namespace {
+
+// Targets scored together, each candidate embedding is read once per block instead of once per target
+constexpr size_t kBlockSize = 64;
+constexpr uint32_t kCacheVersion = 1;
+
+// Scoring is retried with a doubling delay before tiered games fall back to untiered ones
+constexpr size_t kPrepareAttempts = 3;
+constexpr std::chrono::seconds kFirstRetryDelay{5};
+
+// FNV-1a, stable across standard libraries so that a cache file stays valid after a rebuild
+void HashBytes(uint64_t& hash, std::string_view bytes) noexcept { hash = utils::Fnv1a(bytes, hash); }
+
+void HashValue(uint64_t& hash, uint64_t value) noexcept {
+  HashBytes(hash, std::string_view(reinterpret_cast<const char*>(&value), sizeof(value)));
+}
+
+// Cosine similarity in [-1, 1] to one byte
+uint8_t QuantizeSimilarity(float similarity) noexcept {
+  return static_cast<uint8_t>(std::lround((std::clamp(similarity, -1.0f, 1.0f) + 1.0f) * 127.5f));
+}
+
+}  // namespace
+
+TargetDifficultyComponent::TargetDifficultyComponent(const userver::components::ComponentConfig& config,
+                                                     const userver::components::ComponentContext& context)
+    : LoggableComponentBase(config, context),
+      dictionary_(context.FindComponent<WordDictionaryComponent>()),
+      dictionary_filter_(context.FindComponent<DictionaryFilterComponent>()),
+      tier_names_(config["tiers"].As<std::vector<std::string>>(std::vector<std::string>{"easy", "medium", "hard"})),
+      neighbours_(std::max(config["neighbours"].As<size_t>(10), size_t{1})),
+      neighbour_pool_(config["neighbour-pool"].As<size_t>(50000)),
+      parallelism_(std::max(config["parallelism"].As<size_t>(2), size_t{1})),
+      cache_path_(config["cache-path"].As<std::string>("cache/target-difficulty.bin")),
+      compute_task_processor_(
+          context.GetTaskProcessor(config["task-processor"].As<std::string>("compute-task-processor"))),
+      fs_task_processor_(context.GetTaskProcessor(config["fs-task-processor"].As<std::string>("fs-task-processor"))) {
+  if (tier_names_.empty()) {
+    throw std::runtime_error("target-difficulty needs at least one tier");
+  }
+
+  // Startup doesn't wait for the scores, tiered games are refused until they are ready
+  prepare_task_ =
+      userver::utils::Async(compute_task_processor_, "target-difficulty-prepare", [this] { PrepareWithRetries(); });
+
+  statistics_holder_ =
+      context.FindComponent<userver::components::StatisticsStorage>().GetStorage().RegisterWriter(
+          "contexto.difficulty", [this](userver::utils::statistics::Writer& writer) { WriteStatistics(writer); });
+
+  LOG_INFO() << "TargetDifficultyComponent initialized with " << tier_names_.size()
+             << " tiers, neighbours=" << neighbours_ << ", neighbour_pool=" << neighbour_pool_;
+}
+
+TargetDifficultyComponent::~TargetDifficultyComponent() {
+  statistics_holder_.Unregister();
+  if (prepare_task_.IsValid()) prepare_task_.SyncCancel();
+}
+
+std::optional<size_t> TargetDifficultyComponent::FindTier(std::string_view name) const {
+  const auto it = std::ranges::find(tier_names_, name);
+  if (it == tier_names_.end()) return std::nullopt;
+  return static_cast<size_t>(it - tier_names_.begin());
+}
+
+const models::DictionaryWord* TargetDifficultyComponent::GenerateTargetWord(size_t tier) const {
+  std::shared_ptr<const DifficultyTiers> tiers;
+  {
+    std::shared_lock lock(mutex_);
+    tiers = tiers_;
+  }
+  if (!tiers || tier >= tiers->tiers.size() || tiers->tiers[tier].indices.empty()) return nullptr;
+
+  const auto& bucket = tiers->tiers[tier];
+  return &dictionary_.GetDictionary().GetWordWithEmbeddingByIndex(
+      bucket.indices[bucket.table(utils::ThreadLocalRng())]);
+}
+
+TargetDifficultyComponent::ScoredTargets TargetDifficultyComponent::CollectTargets() const {
+  const auto& dictionary = dictionary_.GetDictionary();
+
+  ScoredTargets targets;
+  for (const auto& sampling : dictionary_filter_.GetTargetSampling()) {
+    const auto candidates = dictionary.GetTargetCandidates(sampling.type);
+    targets.indices.insert(targets.indices.end(), candidates.begin(), candidates.end());
+    targets.types.insert(targets.types.end(), candidates.size(), sampling.type);
+  }
+
+  // The pool is picked by frequency rank, since rows aren't guaranteed to be in frequency order
+  const size_t pool_size = neighbour_pool_ == 0 ? dictionary.EmbeddingsSize()
+                                                : std::min(neighbour_pool_, dictionary.EmbeddingsSize());
+  targets.pool.reserve(pool_size);
+  for (size_t i = 0; i < dictionary.EmbeddingsSize(); ++i) {
+    if (dictionary.GetWordWithEmbeddingByIndex(i).frequency_rank < pool_size) {
+      targets.pool.push_back(static_cast<uint32_t>(i));
+    }
+  }
+
+  // Scores depend on the targets, the neighbour pool and the scoring parameters
+  uint64_t fingerprint = utils::kFnv1aOffsetBasis;
+  HashValue(fingerprint, neighbours_);
+  HashValue(fingerprint, dictionary.EmbeddingDimension());
+  for (const auto index : targets.pool) {
+    HashBytes(fingerprint, dictionary.GetWordWithEmbeddingByIndex(index).word_with_pos);
+  }
+  for (const auto index : targets.indices) {
+    HashBytes(fingerprint, dictionary.GetWordWithEmbeddingByIndex(index).word_with_pos);
+  }
+  targets.fingerprint = fingerprint;
+  return targets;
+}
+
+void TargetDifficultyComponent::PrepareWithRetries() {
+  auto delay = kFirstRetryDelay;
+  for (size_t attempt = 1; attempt <= kPrepareAttempts; ++attempt) {
+    try {
+      // A cache file that broke the first attempt isn't read again
+      Prepare(/*use_cache=*/attempt == 1);
+      state_.store(State::kReady, std::memory_order_release);
+      return;
+    } catch (const std::exception& e) {
+      if (userver::engine::current_task::ShouldCancel()) return;
+      prepare_failures_.fetch_add(1, std::memory_order_relaxed);
+      LOG_ERROR() << "Failed to prepare difficulty tiers (attempt " << attempt << " of " << kPrepareAttempts
+                  << "): " << e.what();
+    }
+
+    if (attempt < kPrepareAttempts) {
+      userver::engine::InterruptibleSleepFor(delay);
+      if (userver::engine::current_task::ShouldCancel()) return;
+      delay *= 2;
+    }
+  }
+
+  state_.store(State::kFailed, std::memory_order_release);
+  LOG_ERROR() << "Difficulty tiers are unavailable, tiered games fall back to untiered ones";
+}
+
+void TargetDifficultyComponent::Prepare(bool use_cache) {
+  const auto targets = CollectTargets();
+
+  auto scores = use_cache ? LoadScores(targets) : std::nullopt;
+  if (scores) {
+    loaded_from_cache_ = true;
+    LOG_INFO() << "Loaded difficulty scores of " << scores->size() << " targets from " << cache_path_;
+  } else {
+    const auto scoring_start = std::chrono::steady_clock::now();
+    scores = ComputeScores(targets);
+    const auto scoring_duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - scoring_start);
+    scoring_duration_ms_ = scoring_duration.count();
+
+    LOG_INFO() << "Scored difficulty of " << scores->size() << " targets in " << scoring_duration.count() << "ms";
+    SaveScores(targets, *scores);
+  }
+
+  scored_targets_ = scores->size();
+  auto tiers = BuildTiers(targets, *scores);
+
+  std::lock_guard lock(mutex_);
+  tiers_ = std::move(tiers);
+}
+
+std::vector<uint8_t> TargetDifficultyComponent::ComputeScores(const ScoredTargets& scored) const {
+  const std::span<const uint32_t> targets = scored.indices;
+  std::vector<uint8_t> scores(targets.size());
+  const size_t block_count = (targets.size() + kBlockSize - 1) / kBlockSize;
+
+  // Workers take interleaved blocks, so that each gets a similar mix of targets
+  std::vector<userver::engine::TaskWithResult<void>> workers;
+  workers.reserve(parallelism_);
+  for (size_t worker = 0; worker < parallelism_; ++worker) {
+    workers.push_back(userver::utils::Async(compute_task_processor_, "target-difficulty-score", [&, worker] {
+      for (size_t block = worker; block < block_count; block += parallelism_) {
+        if (userver::engine::current_task::ShouldCancel()) return;
+
+        const size_t begin = block * kBlockSize;
+        const size_t size = std::min(kBlockSize, targets.size() - begin);
+        ScoreBlock(targets.subspan(begin, size), scored.pool, std::span(scores).subspan(begin, size));
+      }
+    }));
+  }
+  for (auto& worker : workers) worker.Get();
+
+  return scores;
+}
+
+void TargetDifficultyComponent::ScoreBlock(std::span<const uint32_t> targets, std::span<const uint32_t> pool,
+                                           std::span<uint8_t> scores) const {
+  const auto& dictionary = dictionary_.GetDictionary();
+
+  std::array<const models::DictionaryWord*, kBlockSize> words{};
+  std::array<VariantRange, kBlockSize> variants{};
+  for (size_t t = 0; t < targets.size(); ++t) {
+    words[t] = &dictionary.GetWordWithEmbeddingByIndex(targets[t]);
+    variants[t] = dictionary.GetPOSVariants(targets[t]);
+  }
+
+  // The k best similarities of every target in ascending order, so the k-th best is the first one
+  std::vector<float> best(targets.size() * neighbours_, -1.0f);
+
+  CooperativeYield yield;
+  for (const size_t candidate_index : pool) {
+    yield.Tick();
+    const auto& candidate = dictionary.GetWordWithEmbeddingByIndex(candidate_index);
+
+    for (size_t t = 0; t < targets.size(); ++t) {
+      const float similarity = words[t]->CalculateSimilarity(candidate);
+      float* top = &best[t * neighbours_];
+      if (similarity <= top[0]) continue;
+
+      // The target and its other POS variants don't count as neighbours
+      if (candidate_index >= variants[t].begin && candidate_index < variants[t].end) continue;
+
+      size_t position = 0;
+      while (position + 1 < neighbours_ && top[position + 1] < similarity) {
+        top[position] = top[position + 1];
+        ++position;
+      }
+      top[position] = similarity;
+    }
+  }
+
+  for (size_t t = 0; t < targets.size(); ++t) {
+    scores[t] = QuantizeSimilarity(best[t * neighbours_]);
+  }
+}
+
+std::optional<std::vector<uint8_t>> TargetDifficultyComponent::LoadScores(const ScoredTargets& targets) const {
+  if (cache_path_.empty()) return std::nullopt;
+
+  const auto load = [&]() -> std::optional<std::vector<uint8_t>> {
+    std::ifstream file(cache_path_, std::ios::binary);
+    if (!file.is_open()) return std::nullopt;
+
+    std::array<char, kCacheMagic.size()> magic{};
+    uint32_t version = 0;
+    uint64_t fingerprint = 0;
+    uint64_t count = 0;
+    file.read(magic.data(), magic.size());
+    file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    file.read(reinterpret_cast<char*>(&fingerprint), sizeof(fingerprint));
+    file.read(reinterpret_cast<char*>(&count), sizeof(count));
+
+    if (!file || std::string_view(magic.data(), magic.size()) != kCacheMagic || version != kCacheVersion ||
+        fingerprint != targets.fingerprint || count != targets.indices.size()) {
+      LOG_INFO() << "Difficulty cache " << cache_path_ << " is missing or stale, scoring targets";
+      return std::nullopt;
+    }
+
+    std::vector<uint8_t> scores(count);
+    file.read(reinterpret_cast<char*>(scores.data()), static_cast<std::streamsize>(count));
+    if (!file) return std::nullopt;
+    return scores;
+  };
+  return userver::utils::Async(fs_task_processor_, "target-difficulty-load", load).Get();
+}
+
+void TargetDifficultyComponent::SaveScores(const ScoredTargets& targets, std::span<const uint8_t> scores) const {
+  if (cache_path_.empty()) return;
+
+  userver::utils::Async(fs_task_processor_, "target-difficulty-save", [&] {
+    const std::filesystem::path path(cache_path_);
+    std::error_code error;
+    if (path.has_parent_path()) std::filesystem::create_directories(path.parent_path(), error);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    const uint64_t count = scores.size();
+    file.write(kCacheMagic.data(), static_cast<std::streamsize>(kCacheMagic.size()));
+    file.write(reinterpret_cast<const char*>(&kCacheVersion), sizeof(kCacheVersion));
+    file.write(reinterpret_cast<const char*>(&targets.fingerprint), sizeof(targets.fingerprint));
+    file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    file.write(reinterpret_cast<const char*>(scores.data()), static_cast<std::streamsize>(scores.size()));
+
+    if (!file) {
+      LOG_WARNING() << "Failed to write difficulty cache " << cache_path_ << ", targets will be scored again";
+    }
+  }).Get();
+}
+
+std::shared_ptr<const DifficultyTiers> TargetDifficultyComponent::BuildTiers(const ScoredTargets& targets,
+                                                                             std::span<const uint8_t> scores) const {
+  const auto& dictionary = dictionary_.GetDictionary();
+  const auto sampling = dictionary_filter_.GetTargetSampling();
+
+  // Each type keeps its share of games inside every tier: the weights of its candidates sum up to its weight
+  std::unordered_map<models::WordType, double> type_totals;
+  for (size_t i = 0; i < targets.indices.size(); ++i) {
+    type_totals[targets.types[i]] += dictionary.GetTargetWeight(targets.types[i], targets.indices[i]);
+  }
+
+  // Crowded neighbourhoods first, so the first tier gets the easiest targets
+  std::vector<uint32_t> order(targets.indices.size());
+  std::iota(order.begin(), order.end(), uint32_t{0});
+  std::stable_sort(order.begin(), order.end(), [&](uint32_t lhs, uint32_t rhs) { return scores[lhs] > scores[rhs]; });
+
+  auto tiers = std::make_shared<DifficultyTiers>();
+  tiers->tiers.resize(tier_names_.size());
+  std::vector<double> weights;
+  for (size_t tier = 0; tier < tier_names_.size(); ++tier) {
+    const size_t begin = order.size() * tier / tier_names_.size();
+    const size_t end = order.size() * (tier + 1) / tier_names_.size();
+
+    auto& bucket = tiers->tiers[tier];
+    weights.clear();
+    for (size_t i = begin; i < end; ++i) {
+      const uint32_t position = order[i];
+      const auto type = targets.types[position];
+      const auto type_sampling = std::ranges::find(sampling, type, &TargetSampling::type);
+      const double type_weight = type_sampling != sampling.end() ? type_sampling->weight : 1.0;
+
+      bucket.indices.push_back(targets.indices[position]);
+      weights.push_back(type_weight * dictionary.GetTargetWeight(type, targets.indices[position]) /
+                        type_totals[type]);
+    }
+    bucket.table = utils::AliasTable(weights);
+
+    LOG_INFO() << "Difficulty tier '" << tier_names_[tier] << "' has " << bucket.indices.size() << " targets";
+  }
+  return tiers;
+}
+
+void TargetDifficultyComponent::WriteStatistics(userver::utils::statistics::Writer& writer) const {
+  std::shared_ptr<const DifficultyTiers> tiers;
+  {
+    std::shared_lock lock(mutex_);
+    tiers = tiers_;
+  }
+
+  writer["ready"] = tiers ? 1 : 0;
+  writer["failed"] = HasFailed() ? 1 : 0;
+  writer["prepare-failures"] = prepare_failures_.load(std::memory_order_relaxed);
+  writer["scored-targets"] = scored_targets_.load(std::memory_order_relaxed);
+  writer["scoring-duration-ms"] = scoring_duration_ms_.load(std::memory_order_relaxed);
+  writer["loaded-from-cache"] = loaded_from_cache_.load(std::memory_order_relaxed) ? 1 : 0;
+  if (tiers) {
+    auto tier_sizes = writer["tier-targets"];
+    for (size_t tier = 0; tier < tiers->tiers.size(); ++tier) {
+      tier_sizes[tier_names_[tier]] = tiers->tiers[tier].indices.size();
+    }
+  }
+}
+
+userver::yaml_config::Schema TargetDifficultyComponent::GetStaticConfigSchema() {
+  return userver::yaml_config::MergeSchemas<userver::components::LoggableComponentBase>(R"(
+type: object
+description: Precomputed target difficulty tiers
+additionalProperties: false
+properties:
+  tiers:
+    type: array
+    description: tier names from easiest to hardest, targets are split into equally sized tiers
+    defaultDescription: "[easy, medium, hard]"
+    items:
+      type: string
+      description: tier name, as passed in the difficulty field of /api/new-game
+  neighbours:
+    type: integer
+    description: a target is scored by the similarity of its k-th nearest neighbour
+    defaultDescription: 10
+  neighbour-pool:
+    type: integer
+    description: neighbours are searched among this many most frequent words, 0 searches all embeddings
+    defaultDescription: 50000
+  parallelism:
+    type: integer
+    description: scoring tasks run at once
+    defaultDescription: 2
+  cache-path:
+    type: string
+    description: file the scores are kept in between restarts, empty disables the cache
+    defaultDescription: cache/target-difficulty.bin
+  task-processor:
+    type: string
+    description: task processor for scoring
+    defaultDescription: compute-task-processor
+  fs-task-processor:
+    type: string
+    description: task processor for the cache file
+    defaultDescription: fs-task-processor
+)");
+}
+
+}  // namespace contexto
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <pch.hpp>
+
+#include <contexto/models/dictionary_word.hpp>
+#include <utils/random_sampling.hpp>
+
+#include <userver/components/loggable_component_base.hpp>
+#include <userver/engine/shared_mutex.hpp>
+#include <userver/engine/task/task_processor_fwd.hpp>
+#include <userver/engine/task/task_with_result.hpp>
+#include <userver/utils/statistics/entry.hpp>
+
+namespace contexto {
+
+class DictionaryFilterComponent;
+class WordDictionaryComponent;
+
+// Target candidates bucketed by difficulty, each bucket with its own alias table
+struct DifficultyTiers {
+  struct Tier {
+    std::vector<uint32_t> indices;
+    utils::AliasTable table;
+  };
+
+  std::vector<Tier> tiers;  // In the order of the configured tier names, easiest first
+};
+
+// Scores every target candidate by how crowded its neighbourhood is: the similarity of its k-th nearest
+// neighbour among the most frequent words. Isolated targets give players little to home in on. Scoring needs
+// a neighbour scan per target, so it runs once in the background and the one-byte scores are cached on disk;
+// afterwards a target of a given difficulty is one alias table draw.
+class TargetDifficultyComponent final : public userver::components::LoggableComponentBase {
+public:
+  static constexpr std::string_view kName = "target-difficulty";
+
+  static constexpr std::string_view kCacheMagic = "CTXDIFF1";
+
+  TargetDifficultyComponent(const userver::components::ComponentConfig& config,
+                            const userver::components::ComponentContext& context);
+  ~TargetDifficultyComponent() override;
+
+  // Index of a configured tier name, nullopt if there is no such tier
+  std::optional<size_t> FindTier(std::string_view name) const;
+
+  // Nullptr until the scores are ready
+  const models::DictionaryWord* GenerateTargetWord(size_t tier) const;
+
+  // Scoring failed on every attempt, tiers will never become ready
+  bool HasFailed() const noexcept { return state_.load(std::memory_order_acquire) == State::kFailed; }
+
+  static userver::yaml_config::Schema GetStaticConfigSchema();
+
+private:
+  enum class State : uint8_t { kPreparing, kReady, kFailed };
+
+  // Scored candidates with the fingerprint of everything their scores depend on
+  struct ScoredTargets {
+    std::vector<uint32_t> indices;
+    std::vector<models::WordType> types;
+    std::vector<uint32_t> pool;  // Rows searched for neighbours, in row order
+    uint64_t fingerprint = 0;
+  };
+
+  ScoredTargets CollectTargets() const;
+  void PrepareWithRetries();
+  void Prepare(bool use_cache);
+  std::vector<uint8_t> ComputeScores(const ScoredTargets& targets) const;
+  void ScoreBlock(std::span<const uint32_t> targets, std::span<const uint32_t> pool,
+                  std::span<uint8_t> scores) const;
+  std::optional<std::vector<uint8_t>> LoadScores(const ScoredTargets& targets) const;
+  void SaveScores(const ScoredTargets& targets, std::span<const uint8_t> scores) const;
+  std::shared_ptr<const DifficultyTiers> BuildTiers(const ScoredTargets& targets,
+                                                    std::span<const uint8_t> scores) const;
+
+  void WriteStatistics(userver::utils::statistics::Writer& writer) const;
+
+  const WordDictionaryComponent& dictionary_;
+  const DictionaryFilterComponent& dictionary_filter_;
+
+  std::vector<std::string> tier_names_;
+  size_t neighbours_;
+  size_t neighbour_pool_;
+  size_t parallelism_;
+  std::string cache_path_;
+  userver::engine::TaskProcessor& compute_task_processor_;
+  userver::engine::TaskProcessor& fs_task_processor_;
+
+  mutable userver::engine::SharedMutex mutex_;
+  std::shared_ptr<const DifficultyTiers> tiers_;
+
+  std::atomic<size_t> scored_targets_ = 0;
+  std::atomic<int64_t> scoring_duration_ms_ = 0;
+  std::atomic<bool> loaded_from_cache_ = false;
+  std::atomic<State> state_ = State::kPreparing;
+  std::atomic<size_t> prepare_failures_ = 0;
+  userver::engine::TaskWithResult<void> prepare_task_;
+  userver::utils::statistics::Entry statistics_holder_;
+};
+
+}  // namespace contexto
@@ -0,0 +1,82 @@
+#include "task_processor_monitor.hpp"
+
+#include <userver/components/component_config.hpp>
+#include <userver/components/component_context.hpp>
+#include <userver/components/statistics_storage.hpp>
+#include <userver/engine/async.hpp>
+#include <userver/logging/log.hpp>
+#include <userver/utils/statistics/writer.hpp>
+#include <userver/yaml_config/merge_schemas.hpp>
+
+namespace contexto {
+
+TaskProcessorMonitor::TaskProcessorMonitor(const userver::components::ComponentConfig& config,
+                                           const userver::components::ComponentContext& context)
+    : LoggableComponentBase(config, context) {
+  const auto names = config["task-processors"].As<std::vector<std::string>>(
+      std::vector<std::string>{"main-task-processor", "compute-task-processor"});
+  const auto probe_interval = config["probe-interval"].As<std::chrono::milliseconds>(std::chrono::milliseconds{100});
+
+  for (const auto& name : names) {
+    probes_.emplace_back(name, &context.GetTaskProcessor(name));
+  }
+
+  probe_task_.Start("task-processor-probe", {probe_interval}, [this] { ProbeAll(); });
+
+  statistics_holder_ =
+      context.FindComponent<userver::components::StatisticsStorage>().GetStorage().RegisterWriter(
+          "contexto.task-processors", [this](userver::utils::statistics::Writer& writer) { WriteStatistics(writer); });
+
+  LOG_INFO() << "TaskProcessorMonitor initialized with " << probes_.size()
+             << " task processors, probe_interval=" << probe_interval.count() << "ms";
+}
+
+TaskProcessorMonitor::~TaskProcessorMonitor() {
+  statistics_holder_.Unregister();
+  probe_task_.Stop();
+}
+
+void TaskProcessorMonitor::ProbeAll() {
+  // All probes are posted before waiting, so a busy processor doesn't delay the others' probes
+  std::vector<userver::engine::TaskWithResult<void>> tasks;
+  tasks.reserve(probes_.size());
+  for (auto& probe : probes_) {
+    const auto posted = std::chrono::steady_clock::now();
+    tasks.push_back(userver::engine::AsyncNoSpan(*probe.task_processor, [&probe, posted] {
+      probe.queue_wait.Account(std::chrono::steady_clock::now() - posted);
+    }));
+  }
+
+  for (auto& task : tasks) {
+    task.Get();
+  }
+}
+
+void TaskProcessorMonitor::WriteStatistics(userver::utils::statistics::Writer& writer) const {
+  for (const auto& probe : probes_) {
+    writer["queue-wait"].ValueWithLabels(probe.queue_wait.GetHistogram(),
+                                         userver::utils::statistics::LabelView("task_processor", probe.name));
+  }
+}
+
+userver::yaml_config::Schema TaskProcessorMonitor::GetStaticConfigSchema() {
+  return userver::yaml_config::MergeSchemas<userver::components::LoggableComponentBase>(R"(
+type: object
+description: Queue wait time probes of task processors
+additionalProperties: false
+properties:
+  task-processors:
+    type: array
+    description: task processors to probe
+    defaultDescription: '[main-task-processor, compute-task-processor]'
+    items:
+      type: string
+      description: task processor name
+  probe-interval:
+    type: string
+    description: how often every task processor is probed
+    defaultDescription: 100ms
+)");
+}
+
+}  // namespace contexto
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "statistics.hpp"
+
+#include <deque>
+
+#include <userver/components/loggable_component_base.hpp>
+#include <userver/engine/task/task_processor_fwd.hpp>
+#include <userver/utils/periodic_task.hpp>
+#include <userver/utils/statistics/entry.hpp>
+
+namespace contexto {
+
+// Measures how long tasks wait in the queue of each task processor. A probe task is posted to every
+// processor periodically and the delay until it starts running goes into a per-processor histogram.
+class TaskProcessorMonitor final : public userver::components::LoggableComponentBase {
+public:
+  static constexpr std::string_view kName = "task-processor-monitor";
+
+  TaskProcessorMonitor(const userver::components::ComponentConfig& config,
+                       const userver::components::ComponentContext& context);
+  ~TaskProcessorMonitor() override;
+
+  static userver::yaml_config::Schema GetStaticConfigSchema();
+
+private:
+  struct Probe {
+    std::string name;
+    userver::engine::TaskProcessor* task_processor;
+    statistics::LatencyHistogram queue_wait;
+  };
+
+  void ProbeAll();
+
+  void WriteStatistics(userver::utils::statistics::Writer& writer) const;
+
+  // Deque elements never move, the probe tasks account into their histograms by reference
+  std::deque<Probe> probes_;
+  userver::utils::PeriodicTask probe_task_;
+  userver::utils::statistics::Entry statistics_holder_;
+};
+
+}  // namespace contexto
@@ -0,0 +1,226 @@
+#include "embedding_projection.hpp"
+
+namespace contexto {
+
+namespace {
+
+using RowMajorMatrix = models::EmbeddingMatrix;
+
+std::vector<size_t> SampleIndices(size_t size, size_t count, std::mt19937& rng) {
+  std::vector<size_t> indices(size);
+  std::iota(indices.begin(), indices.end(), size_t{0});
+  if (count >= size) return indices;
+
+  std::vector<size_t> sample;
+  sample.reserve(count);
+  std::ranges::sample(indices, std::back_inserter(sample), static_cast<std::ptrdiff_t>(count), rng);
+  return sample;
+}
+
+RowMajorMatrix GatherEmbeddings(const RowMajorMatrix& embeddings, std::span<const size_t> indices) {
+  RowMajorMatrix matrix(indices.size(), embeddings.cols());
+  for (size_t row = 0; row < indices.size(); ++row) {
+    matrix.row(row) = embeddings.row(static_cast<Eigen::Index>(indices[row]));
+  }
+  return matrix;
+}
+
+void NormalizeRows(RowMajorMatrix& matrix) {
+  for (Eigen::Index row = 0; row < matrix.rows(); ++row) {
+    const float norm = matrix.row(row).norm();
+    if (norm > 0) matrix.row(row) /= norm;
+  }
+}
+
+std::vector<uint32_t> RankPositions(std::span<const float> values) {
+  // Sorting (value, position) pairs keeps the comparisons in cache and breaks ties by position
+  std::vector<std::pair<float, uint32_t>> order(values.size());
+  for (uint32_t i = 0; i < order.size(); ++i) {
+    order[i] = {values[i], i};
+  }
+  std::ranges::sort(order);
+
+  std::vector<uint32_t> ranks(values.size());
+  for (uint32_t rank = 0; rank < order.size(); ++rank) {
+    ranks[order[rank].second] = rank;
+  }
+  return ranks;
+}
+
+// Spearman correlation of two rankings without ties
+double SpearmanFromRanks(std::span<const uint32_t> lhs_ranks, std::span<const uint32_t> rhs_ranks) {
+  const size_t size = lhs_ranks.size();
+  if (size < 2) return 1.0;
+
+  double squared_differences = 0.0;
+  for (size_t i = 0; i < size; ++i) {
+    const double difference = static_cast<double>(lhs_ranks[i]) - static_cast<double>(rhs_ranks[i]);
+    squared_differences += difference * difference;
+  }
+
+  const auto n = static_cast<double>(size);
+  return 1.0 - 6.0 * squared_differences / (n * (n * n - 1.0));
+}
+
+// Marks the k highest values
+void MarkTopK(std::span<const float> values, size_t k, std::vector<uint32_t>& order, std::vector<bool>& marks) {
+  order.resize(values.size());
+  std::iota(order.begin(), order.end(), 0u);
+  std::ranges::nth_element(order, order.begin() + static_cast<std::ptrdiff_t>(k) - 1,
+                           [&](uint32_t lhs, uint32_t rhs) { return values[lhs] > values[rhs]; });
+
+  marks.assign(values.size(), false);
+  for (size_t i = 0; i < k; ++i) {
+    marks[order[i]] = true;
+  }
+}
+
+}  // namespace
+
+EmbeddingProjection EmbeddingProjection::FitPca(const models::EmbeddingMatrix& embeddings, size_t max_dimension,
+                                                size_t max_samples, std::mt19937& rng) {
+  EmbeddingProjection projection;
+  if (embeddings.rows() == 0 || max_samples == 0) return projection;
+
+  const auto samples = SampleIndices(static_cast<size_t>(embeddings.rows()), max_samples, rng);
+  const RowMajorMatrix data = GatherEmbeddings(embeddings, samples);
+  const auto input_dimension = data.cols();
+  max_dimension = std::min(max_dimension, static_cast<size_t>(input_dimension));
+
+  // Components of the uncentered second moment preserve dot products best in the least-squares sense,
+  // and dot products are what ranking compares
+  const Eigen::MatrixXd moment = (data.transpose() * data).cast<double>() / static_cast<double>(data.rows());
+  const Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> solver(moment);
+
+  // Eigenvalues come in increasing order
+  projection.components_.resize(static_cast<Eigen::Index>(max_dimension), input_dimension);
+  projection.variances_.resize(input_dimension);
+  for (Eigen::Index i = 0; i < input_dimension; ++i) {
+    const Eigen::Index source = input_dimension - 1 - i;
+    projection.variances_[i] = std::max(0.0, solver.eigenvalues()[source]);
+    if (i < projection.components_.rows()) {
+      projection.components_.row(i) = solver.eigenvectors().col(source).cast<float>().transpose();
+    }
+  }
+
+  return projection;
+}
+
+EmbeddingProjection EmbeddingProjection::MakeRandom(size_t input_dimension, size_t max_dimension, std::mt19937& rng) {
+  EmbeddingProjection projection;
+  max_dimension = std::min(max_dimension, input_dimension);
+
+  // Scale doesn't matter since projected vectors are renormalized
+  std::normal_distribution<float> dist(0.0f, 1.0f);
+  projection.components_ = Eigen::MatrixXf::NullaryExpr(static_cast<Eigen::Index>(max_dimension),
+                                                        static_cast<Eigen::Index>(input_dimension),
+                                                        [&] { return dist(rng); });
+  return projection;
+}
+
+Eigen::VectorXf EmbeddingProjection::Apply(const Eigen::VectorXf& embedding, size_t dimension) const {
+  Eigen::VectorXf projected = components_.topRows(static_cast<Eigen::Index>(dimension)) * embedding;
+  const float norm = projected.norm();
+  if (norm > 0) projected /= norm;
+  return projected;
+}
+
+models::EmbeddingMatrix EmbeddingProjection::ApplyToRows(const models::EmbeddingMatrix& embeddings,
+                                                         size_t dimension) const {
+  RowMajorMatrix projected = embeddings * components_.topRows(static_cast<Eigen::Index>(dimension)).transpose();
+  NormalizeRows(projected);
+  return projected;
+}
+
+double EmbeddingProjection::ExplainedVariance(size_t dimension) const noexcept {
+  const double total = variances_.sum();
+  if (total <= 0) return 0.0;
+  return variances_.head(static_cast<Eigen::Index>(std::min(dimension, MaxDimension()))).sum() / total;
+}
+
+std::vector<ProjectionQuality> EvaluateProjection(const models::EmbeddingMatrix& embeddings,
+                                                  const EmbeddingProjection& projection,
+                                                  std::span<const size_t> dimensions,
+                                                  const ProjectionEvaluationOptions& options, std::mt19937& rng) {
+  std::vector<ProjectionQuality> results;
+  if (embeddings.rows() == 0 || options.queries == 0) return results;
+
+  // Queries are drawn from the candidates and skip themselves, like a target among all dictionary words
+  const auto candidates = SampleIndices(static_cast<size_t>(embeddings.rows()), options.candidates, rng);
+  const auto query_positions = SampleIndices(candidates.size(), options.queries, rng);
+  std::vector<size_t> queries;
+  queries.reserve(query_positions.size());
+  for (const size_t position : query_positions) {
+    queries.push_back(candidates[position]);
+  }
+
+  const RowMajorMatrix candidate_embeddings = GatherEmbeddings(embeddings, candidates);
+  const RowMajorMatrix query_embeddings = GatherEmbeddings(embeddings, queries);
+  RowMajorMatrix full_similarities = query_embeddings * candidate_embeddings.transpose();
+
+  // The query itself would be the top neighbour under any projection
+  constexpr float kExcluded = -2.0f;
+  for (size_t query = 0; query < queries.size(); ++query) {
+    full_similarities(static_cast<Eigen::Index>(query), static_cast<Eigen::Index>(query_positions[query])) = kExcluded;
+  }
+
+  const auto row_span = [&](RowMajorMatrix& matrix, size_t row) {
+    return std::span<float>(matrix.row(static_cast<Eigen::Index>(row)).data(), candidates.size());
+  };
+
+  // The full-dimensional rankings are shared by all evaluated dimensions
+  const size_t top_k = std::min(options.top_k, candidates.size() - 1);
+  std::vector<uint32_t> order;
+  std::vector<std::vector<uint32_t>> full_ranks(queries.size());
+  std::vector<std::vector<bool>> full_tops(queries.size());
+  for (size_t query = 0; query < queries.size(); ++query) {
+    full_ranks[query] = RankPositions(row_span(full_similarities, query));
+    if (top_k > 0) MarkTopK(row_span(full_similarities, query), top_k, order, full_tops[query]);
+  }
+
+  // Components are nested, so projecting once onto all of them serves every dimension
+  const RowMajorMatrix all_projected_candidates = candidate_embeddings * projection.Components().transpose();
+  const RowMajorMatrix all_projected_queries = query_embeddings * projection.Components().transpose();
+
+  std::vector<bool> projected_top;
+
+  for (const size_t dimension : dimensions) {
+    if (dimension == 0 || dimension > projection.MaxDimension()) continue;
+
+    const auto columns = static_cast<Eigen::Index>(dimension);
+    RowMajorMatrix projected_candidates = all_projected_candidates.leftCols(columns);
+    RowMajorMatrix projected_queries = all_projected_queries.leftCols(columns);
+    NormalizeRows(projected_candidates);
+    NormalizeRows(projected_queries);
+    RowMajorMatrix projected_similarities = projected_queries * projected_candidates.transpose();
+
+    ProjectionQuality quality{.dimension = dimension, .explained_variance = projection.ExplainedVariance(dimension)};
+    for (size_t query = 0; query < queries.size(); ++query) {
+      const auto projected = row_span(projected_similarities, query);
+      projected[query_positions[query]] = kExcluded;
+
+      quality.spearman += SpearmanFromRanks(full_ranks[query], RankPositions(projected));
+
+      if (top_k == 0) continue;
+      MarkTopK(projected, top_k, order, projected_top);
+      size_t shared = 0;
+      for (size_t i = 0; i < candidates.size(); ++i) {
+        shared += full_tops[query][i] && projected_top[i];
+      }
+      quality.top_k_overlap += static_cast<double>(shared) / static_cast<double>(top_k);
+    }
+
+    quality.spearman /= static_cast<double>(queries.size());
+    quality.top_k_overlap /= static_cast<double>(queries.size());
+    results.push_back(quality);
+  }
+
+  return results;
+}
+
+double SpearmanCorrelation(std::span<const float> lhs, std::span<const float> rhs) {
+  const size_t size = std::min(lhs.size(), rhs.size());
+  return SpearmanFromRanks(RankPositions(lhs.first(size)), RankPositions(rhs.first(size)));
+}
+
+}  // namespace contexto
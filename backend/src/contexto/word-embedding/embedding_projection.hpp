@@ -0,0 +1,78 @@
+#pragma once
+
+#include <contexto/models/dictionary_word.hpp>
+
+namespace contexto {
+
+enum class ProjectionMethod : uint8_t {
+  kNone,
+  kPca,     // Principal components of the embeddings
+  kRandom,  // Gaussian random projection (Johnson-Lindenstrauss)
+};
+
+constexpr std::optional<ProjectionMethod> ParseProjectionMethod(std::string_view str) noexcept {
+  if (str == "none") return ProjectionMethod::kNone;
+  if (str == "pca") return ProjectionMethod::kPca;
+  if (str == "random") return ProjectionMethod::kRandom;
+  return std::nullopt;
+}
+
+// How well projected embeddings preserve the neighbour order of the full ones, averaged over sampled queries
+struct ProjectionQuality {
+  size_t dimension = 0;
+  double spearman = 0.0;            // Rank correlation of the similarities to all candidates
+  double top_k_overlap = 0.0;       // Share of the full top-k neighbours also in the projected top-k
+  double explained_variance = 0.0;  // Share of the embedding energy kept, PCA only
+};
+
+struct ProjectionEvaluationOptions {
+  size_t queries = 100;
+  size_t candidates = 20000;
+  size_t top_k = 100;
+};
+
+struct EmbeddingReductionOptions {
+  ProjectionMethod method = ProjectionMethod::kNone;
+  size_t dimension = 128;
+  size_t fit_samples = 20000;
+  std::vector<size_t> report_dimensions;  // Evaluated and logged in addition to `dimension`
+  ProjectionEvaluationOptions evaluation;
+};
+
+// Linear map from the embedding space to a lower-dimensional one. Components are ordered by importance,
+// so the first d rows form the projection to d dimensions for any d up to MaxDimension().
+class EmbeddingProjection {
+public:
+  // Fits on at most max_samples randomly chosen embeddings
+  static EmbeddingProjection FitPca(const models::EmbeddingMatrix& embeddings, size_t max_dimension,
+                                    size_t max_samples, std::mt19937& rng);
+
+  static EmbeddingProjection MakeRandom(size_t input_dimension, size_t max_dimension, std::mt19937& rng);
+
+  // Projects onto the first `dimension` components and renormalizes, so dot products stay cosines
+  Eigen::VectorXf Apply(const Eigen::VectorXf& embedding, size_t dimension) const;
+  models::EmbeddingMatrix ApplyToRows(const models::EmbeddingMatrix& embeddings, size_t dimension) const;
+
+  const Eigen::MatrixXf& Components() const noexcept { return components_; }
+  size_t InputDimension() const noexcept { return static_cast<size_t>(components_.cols()); }
+  size_t MaxDimension() const noexcept { return static_cast<size_t>(components_.rows()); }
+
+  // Share of the second moment captured by the first `dimension` components, 0 for random projections
+  double ExplainedVariance(size_t dimension) const noexcept;
+
+private:
+  Eigen::MatrixXf components_;  // One component per row
+  Eigen::VectorXd variances_;   // Eigenvalues of all components in decreasing order, PCA only
+};
+
+// Compares the neighbour rankings of sampled queries under the full and the projected embeddings,
+// one result per requested dimension
+std::vector<ProjectionQuality> EvaluateProjection(const models::EmbeddingMatrix& embeddings,
+                                                  const EmbeddingProjection& projection,
+                                                  std::span<const size_t> dimensions,
+                                                  const ProjectionEvaluationOptions& options, std::mt19937& rng);
+
+// Spearman rank correlation of two equally long sequences, ties broken by position
+double SpearmanCorrelation(std::span<const float> lhs, std::span<const float> rhs);
+
+}  // namespace contexto
@@ -1,11 +1,23 @@
 #include "word_dictionary.hpp"
 
+#include <contexto/cooperative_yield.hpp>
 #include <contexto/dictionary_filter_component.hpp>
 
 #include <userver/logging/log.hpp>
 
 namespace contexto {
 
+namespace {
+
+template <typename HashContainer>
+size_t HashContainerBytes(const HashContainer& container) {
+  // Node-based containers: one pointer per bucket plus a node (next pointer and value) per element
+  constexpr size_t kNodeBytes = sizeof(void*) + sizeof(typename HashContainer::value_type);
+  return container.bucket_count() * sizeof(void*) + container.size() * kNodeBytes;
+}
+
+}  // namespace
+
 bool WordDictionary::LoadFromVectorFile(std::string_view file_path, const DictionaryFilterComponent& filter,
                                         bool load_dictionary_from_embeddings) {
   std::ifstream file(file_path.data());
@@ -41,9 +53,9 @@ bool WordDictionary::LoadFromVectorFile(std::string_view file_path, const Dictio
 
   // Clear and pre-allocate storage
   words_with_embeddings_.clear();
+  embeddings_.resize(0, 0);
   word_with_pos_index_.clear();
   word_to_words_with_pos_.clear();
-  type_index_.clear();
 
   if (load_dictionary_from_embeddings) {
     words_.clear();
@@ -51,10 +63,16 @@ bool WordDictionary::LoadFromVectorFile(std::string_view file_path, const Dictio
   }
 
   // We don't know how many words will pass the filter, so we allocate conservatively
-  const size_t estimated_capacity = vocabulary_size / 4;
-  words_with_embeddings_.reserve(estimated_capacity);
-  word_with_pos_index_.reserve(estimated_capacity);
-  word_to_words_with_pos_.reserve(estimated_capacity);
+  const size_t estimated_capacity = vocabulary_size > 0 ? static_cast<size_t>(vocabulary_size / 4) : 0;
+  const auto dimension = static_cast<size_t>(vector_size);
+
+  // Rows are read into flat buffers and regrouped into the word arena and the embedding matrix once the file
+  // is read, so loading allocates only when a buffer grows
+  std::string names;
+  std::vector<uint32_t> name_offsets{0};
+  std::vector<float> values;
+  name_offsets.reserve(estimated_capacity + 1);
+  values.reserve(estimated_capacity * dimension);
 
   if (load_dictionary_from_embeddings) {
     words_.reserve(estimated_capacity);
@@ -64,44 +82,52 @@ bool WordDictionary::LoadFromVectorFile(std::string_view file_path, const Dictio
   size_t loaded_words = 0;
   size_t filtered_words = 0;
   while (std::getline(file, line)) {
-    std::istringstream iss(line);
-    std::string word_with_pos;
+    // Most rows are filtered out, so the word is checked in place before anything is allocated for the row
+    constexpr std::string_view kWhitespace = " \t\r\n";
+    const size_t word_begin = line.find_first_not_of(kWhitespace);
     // Skip invalid lines
-    if (!(iss >> word_with_pos)) {
+    if (word_begin == std::string::npos) {
       ++filtered_words;
       continue;
     }
 
+    const size_t word_end = std::min(line.find_first_of(kWhitespace, word_begin), line.size());
+    const std::string_view word_with_pos(line.data() + word_begin, word_end - word_begin);
     if (filter.ShouldFilterOutEmbedding(word_with_pos)) {
       ++filtered_words;
       continue;
     }
 
-    models::DictionaryWord dict_word{.word_with_pos = std::move(word_with_pos)};
-    const std::string_view word = dict_word.GetWord();
+    std::istringstream iss(line);
+    iss.seekg(static_cast<std::streamoff>(word_end));
 
     // Skip invalid words (this is a basic check that should always be applied)
-    if (word.empty()) {
+    if (models::GetWordFromWordWithPOS(word_with_pos).empty()) {
       ++filtered_words;
       continue;
     }
 
-    dict_word.embedding.resize(vector_size);
-
-    // Read embedding values
-    for (int64_t i = 0; i < vector_size; ++i) {
-      float value = 0.0f;
-      if (!(iss >> value)) break;  // Skip if we can't read the entire vector
-      dict_word.embedding[i] = value;
+    // Read embedding values, a short row keeps zeros in place of the missing ones
+    const size_t row = values.size();
+    values.resize(row + dimension, 0.0f);
+    const std::span<float> embedding(values.data() + row, dimension);
+    for (float& value : embedding) {
+      if (!(iss >> value)) {
+        value = 0.0f;
+        break;
+      }
     }
 
     // Normalize the embedding vector
-    const float norm = dict_word.embedding.norm();
+    float norm = 0.0f;
+    for (const float value : embedding) norm += value * value;
+    norm = std::sqrt(norm);
     if (norm > 0) {
-      dict_word.embedding /= norm;
+      for (float& value : embedding) value /= norm;
     }
 
-    words_with_embeddings_.push_back(std::move(dict_word));
+    names.append(word_with_pos);
+    name_offsets.push_back(static_cast<uint32_t>(names.size()));
     ++loaded_words;
 
     if (loaded_words % 10000 == 0) {
@@ -109,6 +135,7 @@ bool WordDictionary::LoadFromVectorFile(std::string_view file_path, const Dictio
     }
   }
 
+  StoreWords(names, name_offsets, values, dimension);
   BuildIndices();
 
   // If we're using embeddings as dictionary
@@ -129,6 +156,8 @@ bool WordDictionary::LoadFromVectorFile(std::string_view file_path, const Dictio
     words_.shrink_to_fit();
   }
 
+  BuildTargetSamplers(filter.GetTargetSampling());
+
   LOG_INFO() << "Successfully loaded " << words_with_embeddings_.size() << " word embeddings after filtering (skipped "
              << filtered_words << " words that didn't match the filter)";
 
@@ -145,7 +174,6 @@ bool WordDictionary::LoadDictionary(std::string_view dictionary_path, const Dict
 
   words_.clear();
   words_lookup_.clear();
-  dict_type_index_.clear();
 
   // Read number of words if present
   std::string line;
@@ -183,7 +211,6 @@ bool WordDictionary::LoadDictionary(std::string_view dictionary_path, const Dict
         auto& word_with_embeddings = words_with_embeddings_[it->second];
         words_.push_back(word_with_embeddings.word_with_pos);
         words_lookup_.insert(words_.back());
-        dict_type_index_[word_with_embeddings.GetType()].push_back(it->second);
         ++loaded_words;
       } else {
         ++skipped_words;
@@ -196,12 +223,59 @@ bool WordDictionary::LoadDictionary(std::string_view dictionary_path, const Dict
 
   has_dedicated_dictionary_ = true;
   words_.shrink_to_fit();
+  BuildTargetSamplers(filter.GetTargetSampling());
 
   LOG_INFO() << "Loaded " << loaded_words << " unique words from dedicated dictionary (skipped " << skipped_words
              << " duplicates or filtered words)";
   return !words_.empty();
 }
 
+std::vector<ProjectionQuality> WordDictionary::ReduceDimensions(const EmbeddingReductionOptions& options) {
+  const size_t input_dimension = EmbeddingDimension();
+  if (options.method == ProjectionMethod::kNone || input_dimension == 0) return {};
+
+  if (options.dimension == 0 || options.dimension >= input_dimension) {
+    LOG_WARNING() << "Embeddings have " << input_dimension << " dimensions, not reducing them to "
+                  << options.dimension;
+    return {};
+  }
+
+  std::vector<size_t> dimensions;
+  for (const size_t dimension : options.report_dimensions) {
+    if (dimension > 0 && dimension < input_dimension) dimensions.push_back(dimension);
+  }
+  dimensions.push_back(options.dimension);
+  std::ranges::sort(dimensions);
+  const auto [duplicates_begin, duplicates_end] = std::ranges::unique(dimensions);
+  dimensions.erase(duplicates_begin, duplicates_end);
+
+  // A fixed seed keeps the projection, and with it every rank, identical across restarts and replicas
+  constexpr uint32_t kProjectionSeed = 0x5EED;
+  std::mt19937 rng(kProjectionSeed);
+
+  const auto fit_start = std::chrono::steady_clock::now();
+  const auto projection =
+      options.method == ProjectionMethod::kPca
+          ? EmbeddingProjection::FitPca(embeddings_, dimensions.back(), options.fit_samples, rng)
+          : EmbeddingProjection::MakeRandom(input_dimension, dimensions.back(), rng);
+  const auto fit_duration =
+      std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - fit_start);
+
+  auto quality = EvaluateProjection(embeddings_, projection, dimensions, options.evaluation, rng);
+  for (const auto& result : quality) {
+    LOG_INFO() << "Projection to " << result.dimension << " dimensions: spearman=" << result.spearman << ", top-"
+               << options.evaluation.top_k << " overlap=" << result.top_k_overlap
+               << ", explained variance=" << result.explained_variance;
+  }
+
+  embeddings_ = projection.ApplyToRows(embeddings_, options.dimension);
+  BindEmbeddings();
+
+  LOG_INFO() << "Reduced embeddings from " << input_dimension << " to " << options.dimension
+             << " dimensions (fitted in " << fit_duration.count() << " ms)";
+  return quality;
+}
+
 float WordDictionary::CalculateSimilarity(std::string_view word1, std::string_view word2) const {
   // If words are identical, return perfect similarity
   if (word1 == word2) return 1.0f;
@@ -235,192 +309,93 @@ float WordDictionary::CalculateSimilarity(std::string_view word1, std::string_vi
   return std::clamp(similarity, 0.0f, 1.0f);
 }
 
-const models::DictionaryWord* WordDictionary::GetRandomWord() const {
-  if (words_with_embeddings_.empty()) {
-    LOG_ERROR() << "No words available in dictionary";
-    return nullptr;
-  }
-
-  if (has_dedicated_dictionary_ && !words_.empty()) {
-    // Use the dedicated dictionary when available
-    std::uniform_int_distribution<size_t> dist(0, words_.size() - 1);
-    const std::string_view word = words_[dist(rng_)];
-
-    // Find this word in the embeddings
-    const auto it = word_with_pos_index_.find(word);
-    if (it != word_with_pos_index_.end()) {
-      return &words_with_embeddings_[it->second];
-    } else {
-      LOG_WARNING() << "Word '" << word << "' from dedicated dictionary has no embedding";
-
-      // Fall back to any word with embedding
-      std::uniform_int_distribution<size_t> embed_dist(0, words_with_embeddings_.size() - 1);
-      return &words_with_embeddings_[embed_dist(rng_)];
-    }
-  } else if (!words_with_embeddings_.empty()) {
-    // Fall back to embeddings dictionary
-    std::uniform_int_distribution<size_t> dist(0, words_with_embeddings_.size() - 1);
-    return &words_with_embeddings_[dist(rng_)];
-  }
+float WordDictionary::CalculateSimilarity(size_t index1, size_t index2) const noexcept {
+  if (index1 == index2) return 1.0f;
 
-  return nullptr;
+  float similarity = words_with_embeddings_[index1].CalculateSimilarity(words_with_embeddings_[index2]);
+  if (word_types_[index1] == word_types_[index2]) similarity *= 1.1f;
+  return std::clamp(similarity, 0.0f, 1.0f);
 }
 
-const models::DictionaryWord* WordDictionary::GetRandomWordByType(models::WordType type) const {
-  if (words_with_embeddings_.empty()) {
-    LOG_ERROR() << "No words available in dictionary";
-    return nullptr;
-  }
-
-  if (has_dedicated_dictionary_ && !words_.empty()) {
-    // Use the dedicated dictionary when available
-    std::uniform_int_distribution<size_t> dist(0, words_.size() - 1);
-    const std::string_view word = words_[dist(rng_)];
-
-    // Find this word in the embeddings
-    const auto it = word_with_pos_index_.find(word);
-    if (it != word_with_pos_index_.end()) {
-      return &words_with_embeddings_[it->second];
-    } else {
-      LOG_WARNING() << "Word '" << word << "' from dedicated dictionary has no embedding";
+float WordDictionary::CalculateBestVariantSimilarity(VariantRange variants, size_t target_index) const noexcept {
+  if (variants.Empty()) return -1.0f;
+  if (target_index >= variants.begin && target_index < variants.end) return 1.0f;
 
-      // Fall back to any word with embedding
+  // The variants are consecutive rows, so the target row is streamed against one contiguous block
+  const auto& target = words_with_embeddings_[target_index];
+  const auto target_type = word_types_[target_index];
+  const size_t dimension = EmbeddingDimension();
+  const float* row = embeddings_.row(variants.begin).data();
 
-      const auto indices_it = dict_type_index_.find(type);
-      if (indices_it == dict_type_index_.end()) {
-        LOG_ERROR() << "Failed to get random word by type '" << std::to_underlying(type) << "'";
-        return nullptr;
-      }
-      const auto& indices = indices_it->second;
-      std::uniform_int_distribution<size_t> embed_dist(0, indices.size() - 1);
-      return &words_with_embeddings_[indices[embed_dist(rng_)]];
-    }
-  } else if (!words_with_embeddings_.empty()) {
-    // Fall back to embeddings dictionary
-    std::uniform_int_distribution<size_t> dist(0, words_with_embeddings_.size() - 1);
-    return &words_with_embeddings_[dist(rng_)];
+  float best_similarity = -1.0f;
+  for (uint32_t index = variants.begin; index < variants.end; ++index, row += dimension) {
+    float similarity = utils::simd::Dot(row, target.embedding.data(), dimension);
+    if (word_types_[index] == target_type) similarity *= 1.1f;
+    best_similarity = std::max(best_similarity, std::clamp(similarity, 0.0f, 1.0f));
   }
-
-  return nullptr;
+  return best_similarity;
 }
 
-std::vector<const models::DictionaryWord*> WordDictionary::GetRandomWords(size_t count) const {
-  std::vector<const models::DictionaryWord*> result;
-
-  if (words_with_embeddings_.empty()) {
-    LOG_ERROR() << "No words with embeddings available";
-    return result;
-  }
-
-  if (count == 0) return result;
-  if (count == 1) {
-    result.push_back(GetRandomWord());
-    return result;
+const models::DictionaryWord* WordDictionary::GetRandomWordByType(models::WordType type) const {
+  const auto it = target_samplers_.find(type);
+  if (it == target_samplers_.end() || it->second.indices.empty()) {
+    LOG_ERROR() << "Failed to get random word by type '" << static_cast<int>(type) << "'";
+    return nullptr;
   }
 
-  result.reserve(std::min(count, words_with_embeddings_.size()));
-
-  // Generate unique random indices
-  std::unordered_set<size_t> unique_indices;
-  std::uniform_int_distribution<size_t> dist(0, words_with_embeddings_.size() - 1);
-
-  while (unique_indices.size() < std::min(count, words_with_embeddings_.size())) {
-    unique_indices.insert(dist(rng_));
-  }
+  const auto& sampler = it->second;
+  return &words_with_embeddings_[sampler.indices[sampler.table(utils::ThreadLocalRng())]];
+}
 
-  // Collect words
-  for (const size_t idx : unique_indices) {
-    result.push_back(&words_with_embeddings_[idx]);
+const models::DictionaryWord* WordDictionary::GetWordByKey(uint64_t key, models::WordType type) const {
+  const auto it = target_samplers_.find(type);
+  if (it == target_samplers_.end() || it->second.indices.empty()) {
+    LOG_ERROR() << "Failed to get word by type '" << static_cast<int>(type) << "'";
+    return nullptr;
   }
 
-  return result;
+  // Keys of neighbouring days or pool slots are related, the table needs independent bits
+  const auto& sampler = it->second;
+  return &words_with_embeddings_[sampler.indices[sampler.table.Sample(utils::SplitMix64(key))]];
 }
 
 std::vector<const models::DictionaryWord*> WordDictionary::GetRandomWordsByType(models::WordType type,
                                                                                 size_t count) const {
   std::vector<const models::DictionaryWord*> result;
 
-  if (words_with_embeddings_.empty()) {
-    LOG_ERROR() << "No words with embeddings available";
-    return result;
-  }
-
-  if (count == 0) return result;
-  if (count == 1) {
-    result.push_back(GetRandomWordByType(type));
-    return result;
-  }
-
-  // Use appropriate index based on dictionary availability
-  const auto& type_indices = has_dedicated_dictionary_ ? dict_type_index_ : type_index_;
-
-  // If type filter is "Any", just pick random words from all available
-  if (type == models::WordType::kAny) {
-    result.reserve(std::min(count, words_with_embeddings_.size()));
-
-    // Generate unique random indices
-    std::unordered_set<size_t> unique_indices;
-    std::uniform_int_distribution<size_t> dist(0, words_with_embeddings_.size() - 1);
-
-    while (unique_indices.size() < std::min(count, words_with_embeddings_.size())) {
-      unique_indices.insert(dist(rng_));
-    }
-
-    // Collect words
-    for (const size_t idx : unique_indices) {
-      result.push_back(&words_with_embeddings_[idx]);
-    }
-
-    return result;
-  }
-
-  // Check for words of the specific type
-  const auto it = type_indices.find(type);
-  if (it == type_indices.end() || it->second.empty()) {
-    LOG_WARNING() << "No words found for type '" << std::to_underlying(type) << "', falling back to any type";
-    return result;
-  }
-
-  const auto& indices_of_type = it->second;
-  result.reserve(std::min(count, indices_of_type.size()));
-
-  if (count >= indices_of_type.size()) {
-    // Return all words of requested type
-    for (const auto idx : indices_of_type) {
-      result.push_back(&words_with_embeddings_[idx]);
-    }
+  const auto it = target_samplers_.find(type);
+  if (it == target_samplers_.end() || it->second.indices.empty()) {
+    LOG_WARNING() << "No words found for type '" << static_cast<int>(type) << "'";
     return result;
   }
 
-  // Select random words without replacement
-  std::unordered_set<size_t> unique_positions;
-  std::uniform_int_distribution<size_t> dist(0, indices_of_type.size() - 1);
-
-  while (unique_positions.size() < count) {
-    unique_positions.insert(dist(rng_));
+  const auto& indices = it->second.indices;
+  const auto positions = utils::SampleWithoutReplacement(indices.size(), count, utils::ThreadLocalRng());
+  result.reserve(positions.size());
+  for (const size_t position : positions) {
+    result.push_back(&words_with_embeddings_[indices[position]]);
   }
-
-  for (const size_t pos : unique_positions) {
-    result.push_back(&words_with_embeddings_[indices_of_type[pos]]);
-  }
-
   return result;
 }
 
 std::vector<std::pair<const models::DictionaryWord*, float>> WordDictionary::GetMostSimilarWords(std::string_view word,
                                                                                                  size_t count) const {
-  const models::DictionaryWord* dict_word = FindWord(word);
-  if (!dict_word) return {};  // Word not found
+  const auto it = word_with_pos_index_.find(word);
+  if (it == word_with_pos_index_.end()) return {};  // Word not found
+  const models::DictionaryWord* dict_word = &words_with_embeddings_[it->second];
+  const VariantRange same_word = variant_ranges_[it->second];
 
   // Calculate similarity with all words
   using WordWithSimilarity = std::pair<const models::DictionaryWord*, float>;
   std::vector<WordWithSimilarity> similarities;
   similarities.reserve(words_with_embeddings_.size());
 
-  for (const auto& other_word : words_with_embeddings_) {
-    if (other_word.GetWord() == dict_word->GetWord()) continue;  // Skip the same word
-    const float sim = dict_word->CalculateSimilarity(other_word);
-    similarities.emplace_back(&other_word, sim);
+  CooperativeYield yield;
+  for (size_t i = 0; i < words_with_embeddings_.size(); ++i) {
+    yield.Tick();
+    if (i >= same_word.begin && i < same_word.end) continue;  // Skip the same word
+    const auto& other_word = words_with_embeddings_[i];
+    similarities.emplace_back(&other_word, dict_word->CalculateSimilarity(other_word));
   }
 
   // Sort by similarity in descending order
@@ -433,7 +408,36 @@ std::vector<std::pair<const models::DictionaryWord*, float>> WordDictionary::Get
   return similarities;
 }
 
-std::span<const size_t> WordDictionary::GetIndicesToWordPOSVariations(std::string_view word) const noexcept {
+DictionaryMemoryUsage WordDictionary::GetMemoryUsage() const {
+  DictionaryMemoryUsage usage;
+
+  usage.embeddings = words_with_embeddings_.capacity() * sizeof(models::DictionaryWord) +
+                     static_cast<size_t>(embeddings_.size()) * sizeof(float);
+  usage.word_arena = word_arena_.capacity();
+
+  usage.words = words_.capacity() * sizeof(std::string_view) + HashContainerBytes(words_lookup_);
+  usage.word_with_pos_index = HashContainerBytes(word_with_pos_index_);
+
+  usage.word_to_words_with_pos =
+      HashContainerBytes(word_to_words_with_pos_) + variant_ranges_.capacity() * sizeof(VariantRange);
+
+  usage.folded_index = HashContainerBytes(folded_index_) + folded_words_.capacity();
+  usage.word_metadata = word_types_.capacity() * sizeof(models::WordType) +
+                        (word_sizes_.capacity() + word_chars_.capacity() + word_with_pos_chars_.capacity()) *
+                            sizeof(uint16_t) +
+                        prefixes_.capacity() * sizeof(utils::utf8::CodePointPrefix) +
+                        folded_ids_.capacity() * sizeof(uint32_t);
+  usage.spelling_trie = spelling_trie_.MemoryUsage();
+
+  usage.target_samplers = HashContainerBytes(target_samplers_);
+  for (const auto& [type, sampler] : target_samplers_) {
+    usage.target_samplers += sampler.indices.capacity() * sizeof(uint32_t) + sampler.table.MemoryUsage();
+  }
+
+  return usage;
+}
+
+VariantRange WordDictionary::GetPOSVariants(std::string_view word) const noexcept {
   if (models::WordHasPOS(word)) {
     word = models::GetWordFromWordWithPOS(word);
   }
@@ -443,13 +447,72 @@ std::span<const size_t> WordDictionary::GetIndicesToWordPOSVariations(std::strin
   return it->second;
 }
 
+void WordDictionary::StoreWords(std::string_view names, std::span<const uint32_t> name_offsets,
+                                std::span<const float> values, size_t dimension) {
+  const size_t size = name_offsets.size() - 1;
+  const auto name = [&](size_t i) {
+    return names.substr(name_offsets[i], name_offsets[i + 1] - name_offsets[i]);
+  };
+
+  // Bare words numbered in the order of their first, most frequent, variant
+  std::unordered_map<std::string_view, uint32_t> groups;
+  groups.reserve(size);
+  std::vector<uint32_t> word_groups(size);
+  for (size_t i = 0; i < size; ++i) {
+    const std::string_view word = models::GetWordFromWordWithPOS(name(i));
+    word_groups[i] = groups.try_emplace(word, static_cast<uint32_t>(groups.size())).first->second;
+  }
+
+  // Counting sort by group keeps the variants of a group in frequency order
+  std::vector<uint32_t> group_offsets(groups.size() + 1);
+  for (const auto group : word_groups) ++group_offsets[group + 1];
+  std::partial_sum(group_offsets.begin(), group_offsets.end(), group_offsets.begin());
+
+  std::vector<uint32_t> order(size);
+  for (size_t i = 0; i < size; ++i) {
+    order[group_offsets[word_groups[i]]++] = static_cast<uint32_t>(i);
+  }
+  groups.clear();
+
+  // The arena is sized once, so the views of the words into it stay valid; variants of a word, and with them
+  // the words compared while building the indices, end up next to each other
+  word_arena_.assign(names.size(), '\0');
+  words_with_embeddings_.clear();
+  words_with_embeddings_.reserve(size);
+  embeddings_.resize(static_cast<Eigen::Index>(size), static_cast<Eigen::Index>(dimension));
+
+  size_t arena_offset = 0;
+  for (size_t row = 0; row < size; ++row) {
+    const std::string_view word_with_pos = name(order[row]);
+    std::copy(word_with_pos.begin(), word_with_pos.end(), word_arena_.data() + arena_offset);
+    std::copy_n(values.data() + order[row] * dimension, dimension, embeddings_.row(row).data());
+
+    // Filtered lines don't count, ranks follow the order of the loaded words
+    words_with_embeddings_.push_back(models::DictionaryWord{
+        .word_with_pos = std::string_view(word_arena_.data() + arena_offset, word_with_pos.size()),
+        .embedding = {},
+        .frequency_rank = order[row],
+    });
+    arena_offset += word_with_pos.size();
+  }
+
+  BindEmbeddings();
+}
+
+void WordDictionary::BindEmbeddings() {
+  const auto dimension = static_cast<size_t>(embeddings_.cols());
+  for (size_t i = 0; i < words_with_embeddings_.size(); ++i) {
+    words_with_embeddings_[i].embedding = std::span<const float>(embeddings_.row(i).data(), dimension);
+  }
+}
+
 void WordDictionary::BuildIndices() {
   word_with_pos_index_.clear();
   word_to_words_with_pos_.clear();
-  type_index_.clear();
 
   word_with_pos_index_.reserve(words_with_embeddings_.size());
   word_to_words_with_pos_.reserve(words_with_embeddings_.size());
+  variant_ranges_.resize(words_with_embeddings_.size());
 
   for (size_t i = 0; i < words_with_embeddings_.size(); ++i) {
     const auto& dict_word = words_with_embeddings_[i];
@@ -457,14 +520,186 @@ void WordDictionary::BuildIndices() {
     // Index by the full word with POS
     word_with_pos_index_[dict_word.word_with_pos] = i;
 
-    // Index by just the word part
+    // Index by just the word part; variants are adjacent, so a bare word only ever extends its last range
+    const std::string_view word = dict_word.GetWord();
+    auto& range = word_to_words_with_pos_.try_emplace(word, VariantRange{static_cast<uint32_t>(i), 0}).first->second;
+    UASSERT_MSG(range.end == 0 || range.end == i, "POS variants of a word must be stored in adjacent rows");
+    range.end = static_cast<uint32_t>(i + 1);
+  }
+
+  for (const auto& [word, range] : word_to_words_with_pos_) {
+    std::fill(variant_ranges_.begin() + range.begin, variant_ranges_.begin() + range.end, range);
+  }
+
+  BuildWordMetadata();
+  BuildFoldedIndex();
+}
+
+void WordDictionary::BuildWordMetadata() {
+  const size_t size = words_with_embeddings_.size();
+  word_types_.resize(size);
+  word_sizes_.resize(size);
+  word_chars_.resize(size);
+  word_with_pos_chars_.resize(size);
+  prefixes_.resize(size);
+
+  // Longer words don't occur in practice; their counts saturate, which only caps their prefix score
+  constexpr size_t kMaxCount = std::numeric_limits<uint16_t>::max();
+  for (size_t i = 0; i < size; ++i) {
+    const auto& dict_word = words_with_embeddings_[i];
     const std::string_view word = dict_word.GetWord();
-    word_to_words_with_pos_[word].push_back(i);
+    word_types_[i] = dict_word.GetType();
+    word_sizes_[i] = static_cast<uint16_t>(std::min(word.size(), kMaxCount));
+    word_chars_[i] = static_cast<uint16_t>(std::min(utils::utf8::CharCount(word), kMaxCount));
+    word_with_pos_chars_[i] =
+        static_cast<uint16_t>(std::min(utils::utf8::CharCount(dict_word.word_with_pos), kMaxCount));
+    prefixes_[i] = utils::utf8::MakeCodePointPrefix(dict_word.word_with_pos);
+  }
+}
+
+size_t WordDictionary::CommonPrefixLength(size_t index, bool with_pos, size_t bare_index) const noexcept {
+  // Lanes past the shorter text may still match, e.g. the POS separator after a bare word
+  const size_t prefix_length = utils::utf8::CommonPrefixLength(prefixes_[index], prefixes_[bare_index]);
+  return std::min({prefix_length, GetCharCount(index, with_pos), GetCharCount(bare_index, false)});
+}
+
+bool WordDictionary::FoldedEqual(size_t index, bool with_pos, size_t bare_index) const noexcept {
+  if (!with_pos) return folded_ids_[index] == folded_ids_[bare_index];
 
-    // Index by word type
-    const models::WordType type = dict_word.GetType();
-    type_index_[type].push_back(i);
+  // Folding keeps the byte length, so a word with a POS tag rarely gets as far as the string comparison
+  const std::string_view word_with_pos = words_with_embeddings_[index].word_with_pos;
+  if (word_with_pos.size() != word_sizes_[bare_index]) return false;
+  return utils::utf8::FoldedEqual(word_with_pos, GetWord(bare_index));
+}
+
+double WordDictionary::GetTargetWeight(models::WordType type, uint32_t index) const noexcept {
+  const auto it = target_samplers_.find(type);
+  if (it == target_samplers_.end() || it->second.frequency_exponent == 0.0) return 1.0;
+
+  // The frequency distribution is Zipf over the corpus frequency rank
+  const double rank = words_with_embeddings_[index].frequency_rank;
+  return std::pow(rank + 1.0, -it->second.frequency_exponent);
+}
+
+void WordDictionary::BuildTargetSamplers(std::span<const TargetSampling> sampling) {
+  target_samplers_.clear();
+
+  // A dedicated dictionary that failed to load leaves the embeddings as candidates
+  std::vector<uint32_t> candidates;
+  if (has_dedicated_dictionary_ && !words_.empty()) {
+    candidates.reserve(words_.size());
+    for (const auto word : words_) {
+      candidates.push_back(static_cast<uint32_t>(word_with_pos_index_.at(word)));
+    }
+  } else {
+    candidates.resize(words_with_embeddings_.size());
+    std::iota(candidates.begin(), candidates.end(), uint32_t{0});
+  }
+
+  for (const auto index : candidates) {
+    target_samplers_[word_types_[index]].indices.push_back(index);
+  }
+  target_samplers_[models::WordType::kAny].indices = std::move(candidates);
+
+  std::vector<double> weights;
+  for (auto& [type, sampler] : target_samplers_) {
+    const auto options = std::ranges::find(sampling, type, &TargetSampling::type);
+    if (options != sampling.end() && options->distribution == TargetDistribution::kFrequency) {
+      sampler.frequency_exponent = options->frequency_exponent;
+    }
+
+    weights.resize(sampler.indices.size());
+    for (size_t i = 0; i < sampler.indices.size(); ++i) {
+      weights[i] = GetTargetWeight(type, sampler.indices[i]);
+    }
+
+    sampler.indices.shrink_to_fit();
+    sampler.table = utils::AliasTable(weights);
+  }
+
+  LOG_INFO() << "Built target samplers for " << target_samplers_.size() << " word types over "
+             << target_samplers_[models::WordType::kAny].indices.size() << " candidates";
+}
+
+void WordDictionary::BuildFoldedIndex() {
+  folded_index_.clear();
+  folded_words_.clear();
+
+  // Folding never makes a word longer, so all keys fit into one buffer sized up front and
+  // views into it stay valid
+  size_t total_size = 0;
+  for (const auto& dict_word : words_with_embeddings_) {
+    total_size += dict_word.GetWord().size();
+  }
+  folded_words_.resize(total_size);
+  folded_index_.reserve(word_to_words_with_pos_.size());
+  folded_ids_.resize(words_with_embeddings_.size());
+
+  // Folded keys mapped to the embedding index of their canonical spelling, for the spelling trie
+  std::vector<std::pair<std::string_view, uint32_t>> trie_keys;
+  trie_keys.reserve(word_to_words_with_pos_.size());
+
+  // Bare words are ordered by the frequency of their most frequent variant, so the first spelling of a key is
+  // the most frequent one
+  size_t offset = 0;
+  for (size_t i = 0; i < words_with_embeddings_.size(); ++i) {
+    const std::string_view word = GetWord(i);
+    const size_t folded_size = utils::utf8::Fold(word, folded_words_.data() + offset);
+    const std::string_view folded(folded_words_.data() + offset, folded_size);
+
+    const auto [it, inserted] = folded_index_.try_emplace(folded, static_cast<uint32_t>(i));
+    folded_ids_[i] = it->second;
+    if (inserted) {
+      trie_keys.emplace_back(folded, static_cast<uint32_t>(i));
+      offset += folded_size;
+    }
+  }
+
+  // Shrinking keeps the buffer in place, so the views stay valid
+  folded_words_.resize(offset);
+  LOG_INFO() << "Built folded word index with " << folded_index_.size() << " keys";
+
+  spelling_trie_.Build(std::move(trie_keys));
+  LOG_INFO() << "Built spelling trie with " << spelling_trie_.NodeCount() << " nodes";
+}
+
+std::pmr::vector<SpellingSuggestion> WordDictionary::FindSimilarSpellings(std::string_view word, size_t max_distance,
+                                                                          size_t limit,
+                                                                          std::pmr::memory_resource* resource) const {
+  std::pmr::vector<SpellingSuggestion> suggestions(resource);
+  if (word.size() > utils::utf8::kMaxFoldedWordSize || models::WordHasPOS(word)) return suggestions;
+
+  std::array<char, utils::utf8::kMaxFoldedWordSize> buffer;
+  const size_t folded_size = utils::utf8::Fold(word, buffer.data());
+
+  const auto matches =
+      spelling_trie_.FindWithinDistance(std::string_view(buffer.data(), folded_size), max_distance, limit, resource);
+  suggestions.reserve(matches.size());
+  for (const auto& match : matches) {
+    suggestions.push_back(SpellingSuggestion{
+        .word = GetWord(match.word_id),
+        .distance = match.distance,
+    });
+  }
+
+  return suggestions;
+}
+
+size_t WordDictionary::FindCompletions(std::string_view prefix, std::span<std::string_view> out) const {
+  if (prefix.size() > utils::utf8::kMaxFoldedWordSize) return 0;
+
+  std::array<char, utils::utf8::kMaxFoldedWordSize> buffer;
+  const size_t folded_size = utils::utf8::Fold(prefix, buffer.data());
+
+  // Bare words are ordered by frequency, so the trie's lowest ids are the most frequent words
+  std::array<uint32_t, WordTrie::kMaxCompletions> ids;
+  const size_t count = spelling_trie_.FindWithPrefix(std::string_view(buffer.data(), folded_size),
+                                                     std::span(ids).first(std::min(out.size(), ids.size())));
+  for (size_t i = 0; i < count; ++i) {
+    out[i] = GetWord(ids[i]);
   }
+
+  return count;
 }
 
 }  // namespace contexto
@@ -1,12 +1,44 @@
 #pragma once
 
 #include <contexto/models/dictionary_word.hpp>
+#include <contexto/word-embedding/embedding_projection.hpp>
+#include <contexto/word-embedding/word_trie.hpp>
+#include <utils/random_sampling.hpp>
 
 #include <userver/utils/assert.hpp>
 
 namespace contexto {
 
 class DictionaryFilterComponent;
+struct TargetSampling;
+
+// Approximate heap footprint of the dictionary storage, in bytes
+struct DictionaryMemoryUsage {
+  size_t embeddings = 0;
+  size_t word_arena = 0;
+  size_t words = 0;
+  size_t word_with_pos_index = 0;
+  size_t word_to_words_with_pos = 0;
+  size_t folded_index = 0;
+  size_t spelling_trie = 0;
+  size_t target_samplers = 0;
+  size_t word_metadata = 0;
+};
+
+// Embedding indices [begin, end) of the POS variants of a bare word. Variants are stored in adjacent rows of the
+// embedding matrix, ordered by their frequency.
+struct VariantRange {
+  uint32_t begin = 0;
+  uint32_t end = 0;
+
+  size_t Size() const noexcept { return end - begin; }
+  bool Empty() const noexcept { return begin == end; }
+};
+
+struct SpellingSuggestion {
+  std::string_view word;
+  size_t distance = 0;
+};
 
 class WordDictionary {
 public:
@@ -20,6 +52,10 @@ public:
 
   bool LoadDictionary(std::string_view dictionary_path, const DictionaryFilterComponent& filter, size_t max_words = 0);
 
+  // Replaces every embedding with its projection to options.dimension dimensions. Returns how well each
+  // evaluated dimension preserves neighbour ranks; empty if nothing was reduced.
+  std::vector<ProjectionQuality> ReduceDimensions(const EmbeddingReductionOptions& options);
+
   const models::DictionaryWord* FindWord(std::string_view word) const {
     const auto it = word_with_pos_index_.find(word);
     if (it != word_with_pos_index_.end()) {
@@ -31,17 +67,85 @@ public:
 
   float CalculateSimilarity(std::string_view word1, std::string_view word2) const;
 
+  // Similarity of two embeddings with the same-type boost, clamped to [0, 1]
+  float CalculateSimilarity(size_t index1, size_t index2) const noexcept;
+
+  // Best boosted similarity of any POS variant to the target, in one pass over adjacent rows; -1 if there are none
+  float CalculateBestVariantSimilarity(VariantRange variants, size_t target_index) const noexcept;
+
   bool ContainsWord(std::string_view word) const {
     return word_with_pos_index_.contains(word) || word_to_words_with_pos_.contains(word);
   }
 
   bool DictionaryContains(std::string_view word) const { return words_lookup_.contains(word); }
 
-  const models::DictionaryWord* GetRandomWord() const;
+  // Resolves any casing, ё/е spelling or surrounding whitespace of a bare word to its dictionary spelling.
+  // When several spellings fold to the same key the most frequent one wins. Returns an empty view if not found.
+  std::string_view FindCanonicalWord(std::string_view word) const {
+    if (word.size() > utils::utf8::kMaxFoldedWordSize) return {};
+
+    // Words with an explicit POS tag are only matched exactly
+    if (models::WordHasPOS(word)) {
+      const auto it = word_with_pos_index_.find(word);
+      return it != word_with_pos_index_.end() ? it->first : std::string_view{};
+    }
+
+    std::array<char, utils::utf8::kMaxFoldedWordSize> buffer;
+    const size_t folded_size = utils::utf8::Fold(word, buffer.data());
+
+    const auto it = folded_index_.find(std::string_view(buffer.data(), folded_size));
+    if (it == folded_index_.end()) return {};
+    return GetWord(it->second);
+  }
+
+  // Dictionary spellings within max_distance edits of the folded word, closest and most frequent first.
+  // The result and the search temporaries are allocated from resource.
+  std::pmr::vector<SpellingSuggestion> FindSimilarSpellings(
+      std::string_view word, size_t max_distance, size_t limit,
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const;
+
+  // Writes the most frequent dictionary spellings starting with the folded prefix into out and returns their count
+  size_t FindCompletions(std::string_view prefix, std::span<std::string_view> out) const;
+
+  // Embedding index a canonical spelling (see FindCanonicalWord) resolves to, the first POS variant for bare words
+  std::optional<size_t> FindWordIndex(std::string_view canonical_word) const {
+    if (models::WordHasPOS(canonical_word)) {
+      const auto it = word_with_pos_index_.find(canonical_word);
+      if (it == word_with_pos_index_.end()) return std::nullopt;
+      return it->second;
+    }
+
+    const auto it = word_to_words_with_pos_.find(canonical_word);
+    if (it == word_to_words_with_pos_.end()) return std::nullopt;
+    return it->second.begin;
+  }
+
+  // Target candidates are the dedicated dictionary words if one is loaded, otherwise all embeddings. Single draws
+  // are O(1) and follow the distribution configured for the type (see TargetSampling), uniform by default.
+  const models::DictionaryWord* GetRandomWord() const { return GetRandomWordByType(models::WordType::kAny); }
   const models::DictionaryWord* GetRandomWordByType(models::WordType type) const;
-  std::vector<const models::DictionaryWord*> GetRandomWords(size_t count) const;
+
+  // Deterministic counterpart of GetRandomWordByType: the same key always selects the same word of a loaded
+  // dictionary, on every host. kAny selects among all candidate words.
+  const models::DictionaryWord* GetWordByKey(uint64_t key, models::WordType type = models::WordType::kAny) const;
+
+  // Distinct candidates drawn uniformly, all of them if there are no more than count
+  std::vector<const models::DictionaryWord*> GetRandomWords(size_t count) const {
+    return GetRandomWordsByType(models::WordType::kAny, count);
+  }
   std::vector<const models::DictionaryWord*> GetRandomWordsByType(models::WordType type, size_t count) const;
 
+  // Embedding indices of the target candidates of the type, in a fixed order for a loaded dictionary
+  std::span<const uint32_t> GetTargetCandidates(models::WordType type) const noexcept {
+    const auto it = target_samplers_.find(type);
+    if (it == target_samplers_.end()) return {};
+    return it->second.indices;
+  }
+
+  // Unnormalized weight of a candidate of the type under the distribution configured for the type
+  double GetTargetWeight(models::WordType type, uint32_t index) const noexcept;
+
+  // Scans the whole vocabulary, yielding periodically; run it on the compute task processor
   std::vector<std::pair<const models::DictionaryWord*, float>> GetMostSimilarWords(std::string_view word,
                                                                                    size_t count = 10) const;
 
@@ -58,31 +162,96 @@ public:
     return nullptr;
   }
 
-  std::span<const size_t> GetIndicesToWordPOSVariations(std::string_view word) const noexcept;
+  // Metadata of an embedding, precomputed at load so that ranking never parses a word
+  models::WordType GetWordType(size_t index) const noexcept { return word_types_[index]; }
+  std::string_view GetWord(size_t index) const noexcept {
+    return std::string_view(words_with_embeddings_[index].word_with_pos).substr(0, word_sizes_[index]);
+  }
+  // Whether the bare word of an embedding is the spelling its folded form resolves to (see FindCanonicalWord)
+  bool IsCanonicalSpelling(size_t index) const noexcept { return folded_ids_[index] == index; }
+  size_t GetCharCount(size_t index, bool with_pos) const noexcept {
+    return with_pos ? word_with_pos_chars_[index] : word_chars_[index];
+  }
+
+  // utils::utf8::CommonPrefixLength of a word, bare or with its POS tag, and a bare word. Exact up to
+  // utils::utf8::CodePointPrefix::kSize code points.
+  size_t CommonPrefixLength(size_t index, bool with_pos, size_t bare_index) const noexcept;
+
+  // utils::utf8::FoldedEqual of a word, bare or with its POS tag, and a bare word
+  bool FoldedEqual(size_t index, bool with_pos, size_t bare_index) const noexcept;
+
+  // POS variants of the bare word, a POS tag of the word is ignored; empty if the word is unknown
+  VariantRange GetPOSVariants(std::string_view word) const noexcept;
+
+  // Variants of the bare word of the embedding, without any lookup
+  VariantRange GetPOSVariants(size_t index) const noexcept {
+    UASSERT(index < variant_ranges_.size());
+    return variant_ranges_[index];
+  }
 
   WordDictionary& operator=(const WordDictionary&) = delete;
   WordDictionary& operator=(WordDictionary&&) noexcept = default;
 
   size_t EmbeddingsSize() const noexcept { return words_with_embeddings_.size(); }
+  size_t EmbeddingDimension() const noexcept { return static_cast<size_t>(embeddings_.cols()); }
   size_t DictionarySize() const noexcept { return words_.size(); }
   bool HasDedicatedDictionary() const noexcept { return has_dedicated_dictionary_; }
 
+  DictionaryMemoryUsage GetMemoryUsage() const;
+
 private:
+  // Takes the loaded rows in file order: word i is names[name_offsets[i], name_offsets[i + 1]) and its embedding
+  // the i-th run of dimension values. Groups the POS variants of every bare word into adjacent rows, in the order
+  // of their most frequent variant, and copies the words into word_arena_ and the embeddings into embeddings_.
+  void StoreWords(std::string_view names, std::span<const uint32_t> name_offsets, std::span<const float> values,
+                  size_t dimension);
+  void BindEmbeddings();
   void BuildIndices();
+  void BuildWordMetadata();
+  void BuildFoldedIndex();
+  void BuildTargetSamplers(std::span<const TargetSampling> sampling);
   static std::string NormalizeWord(std::string_view word) { return utils::utf8::ToLower(word); }
 
   std::vector<models::DictionaryWord> words_with_embeddings_;
+  std::vector<char> word_arena_;        // Every word_with_pos back to back, in row order; unlike a string it
+                                        // keeps its buffer on move, so the views survive moving the dictionary
+  models::EmbeddingMatrix embeddings_;  // Row i is the embedding of words_with_embeddings_[i]
   std::vector<std::string_view> words_;
   std::unordered_set<std::string_view> words_lookup_;  // For fast lookup
 
   // Use indices instead of pointers
   std::unordered_map<std::string_view, size_t> word_with_pos_index_;
-  std::unordered_map<std::string_view, std::vector<size_t>> word_to_words_with_pos_;
-  std::unordered_map<models::WordType, std::vector<size_t>> type_index_;
-  std::unordered_map<models::WordType, std::vector<size_t>> dict_type_index_;
+  std::unordered_map<std::string_view, VariantRange> word_to_words_with_pos_;
+  std::vector<VariantRange> variant_ranges_;  // Variants of the bare word of each embedding
+
+  // Folded form (see utils::utf8::Fold) -> embedding index of its canonical spelling, keys point into folded_words_,
+  // which is a vector like word_arena_ so that a short buffer isn't moved inline along with the dictionary
+  std::vector<char> folded_words_;
+  std::unordered_map<std::string_view, uint32_t> folded_index_;
+
+  // Metadata columns, one entry per embedding. Code points and prefixes are of the bare word and of the word with
+  // its POS tag; prefixes of the latter serve both, since the bare word is its prefix.
+  std::vector<models::WordType> word_types_;
+  std::vector<uint16_t> word_sizes_;  // Bytes of the bare word
+  std::vector<uint16_t> word_chars_;
+  std::vector<uint16_t> word_with_pos_chars_;
+  std::vector<utils::utf8::CodePointPrefix> prefixes_;
+  std::vector<uint32_t> folded_ids_;  // Equal for bare words with the same folded form
+
+  // Folded keys -> embedding index of their canonical spelling, for typo-tolerant lookup and completion
+  WordTrie spelling_trie_;
+
+  // Target candidates of one type with an alias table over their weights
+  struct TargetSampler {
+    std::vector<uint32_t> indices;
+    utils::AliasTable table;
+    double frequency_exponent = 0.0;  // 0 for the uniform distribution
+  };
+
+  // Rebuilt after every load, for kAny and every type of the candidates
+  std::unordered_map<models::WordType, TargetSampler> target_samplers_;
 
   bool has_dedicated_dictionary_ = false;
-  mutable std::mt19937 rng_{std::random_device{}()};
 };
 
 }  // namespace contexto
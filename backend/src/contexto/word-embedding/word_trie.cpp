@@ -0,0 +1,237 @@
+#include "word_trie.hpp"
+
+namespace contexto {
+
+struct WordTrie::SearchContext {
+  std::array<char32_t, kMaxQueryLength> query{};
+  size_t query_length = 0;
+  size_t max_distance = 0;
+  size_t limit = 0;
+  std::pmr::vector<Match>& matches;
+
+  // One Levenshtein DP row per trie depth: rows[depth][j] is the distance between the first j query
+  // code points and the path to the current node. The search stops descending once a whole row
+  // exceeds max_distance, which makes it a walk of the Levenshtein automaton over the trie.
+  std::array<std::array<uint8_t, kMaxQueryLength + 1>, kMaxQueryLength * 2 + 2> rows{};
+
+  void AddMatch(Match match) {
+    const auto better = [](const Match& lhs, const Match& rhs) {
+      return lhs.distance != rhs.distance ? lhs.distance < rhs.distance : lhs.word_id < rhs.word_id;
+    };
+
+    if (matches.size() == limit) {
+      if (!better(match, matches.back())) return;
+      matches.pop_back();
+    }
+    matches.insert(std::ranges::upper_bound(matches, match, better), match);
+  }
+};
+
+void WordTrie::Build(std::vector<std::pair<std::string_view, uint32_t>> words) {
+  labels_.clear();
+  child_offsets_.clear();
+  values_.clear();
+  subtree_min_ids_.clear();
+
+  // UTF-8 byte order is code point order, so sibling labels come out sorted
+  std::ranges::sort(words, {}, &std::pair<std::string_view, uint32_t>::first);
+
+  // Byte offset of the next undecoded code point of every key. Each key belongs to exactly one node
+  // per depth and nodes are created in breadth-first order, so every cursor advances monotonically.
+  std::vector<size_t> cursors(words.size(), 0);
+
+  // Key ranges of the nodes in creation order; node i owns [ranges[i].first, ranges[i].second)
+  std::vector<std::pair<size_t, size_t>> ranges;
+
+  labels_.push_back(0);
+  values_.push_back(kNoWord);
+  ranges.emplace_back(0, words.size());
+
+  for (size_t node = 0; node < ranges.size(); ++node) {
+    child_offsets_.push_back(static_cast<uint32_t>(labels_.size()));
+
+    const auto [begin, end] = ranges[node];
+    for (size_t group_begin = begin; group_begin < end;) {
+      const std::string_view first_key = words[group_begin].first;
+      const char32_t label = utils::utf8::DecodeCodePoint(first_key, cursors[group_begin]);
+
+      size_t group_end = group_begin;
+      for (; group_end < end; ++group_end) {
+        const std::string_view key = words[group_end].first;
+        if (utils::utf8::DecodeCodePoint(key, cursors[group_end]) != label) break;
+        cursors[group_end] += std::max(1, utils::utf8::CharLen(key, cursors[group_end]));
+      }
+
+      // A key ending at this child sorts before its extensions
+      const bool is_terminal = cursors[group_begin] >= first_key.size();
+      labels_.push_back(label);
+      values_.push_back(is_terminal ? words[group_begin].second : kNoWord);
+      ranges.emplace_back(is_terminal ? group_begin + 1 : group_begin, group_end);
+
+      group_begin = group_end;
+    }
+  }
+
+  child_offsets_.push_back(static_cast<uint32_t>(labels_.size()));
+
+  // Children always follow their parent, so a reverse sweep sees every subtree before its root
+  subtree_min_ids_ = values_;
+  for (size_t node = labels_.size(); node-- > 0;) {
+    for (uint32_t child = child_offsets_[node]; child < child_offsets_[node + 1]; ++child) {
+      subtree_min_ids_[node] = std::min(subtree_min_ids_[node], subtree_min_ids_[child]);
+    }
+  }
+
+  labels_.shrink_to_fit();
+  child_offsets_.shrink_to_fit();
+  values_.shrink_to_fit();
+  subtree_min_ids_.shrink_to_fit();
+}
+
+uint32_t WordTrie::FindNode(std::string_view prefix) const {
+  uint32_t node = 0;
+  for (size_t index = 0; index < prefix.size();) {
+    const char32_t label = utils::utf8::DecodeCodePoint(prefix, index);
+    index += std::max(1, utils::utf8::CharLen(prefix, index));
+
+    // Sibling labels are sorted
+    const auto children_begin = labels_.begin() + child_offsets_[node];
+    const auto children_end = labels_.begin() + child_offsets_[node + 1];
+    const auto it = std::lower_bound(children_begin, children_end, label);
+    if (it == children_end || *it != label) return kNoWord;
+
+    node = static_cast<uint32_t>(it - labels_.begin());
+  }
+
+  return node;
+}
+
+size_t WordTrie::FindWithPrefix(std::string_view prefix, std::span<uint32_t> out) const {
+  const size_t limit = std::min(out.size(), kMaxCompletions);
+  if (Empty() || limit == 0) return 0;
+
+  const uint32_t prefix_node = FindNode(prefix);
+  if (prefix_node == kNoWord) return 0;
+
+  // Best-first search over disjoint candidates: whole subtrees keyed by their lowest id, or single words.
+  // Every candidate holds a word with exactly its key, so only the `limit - found` lowest ones can
+  // contribute and the rest are dropped, which bounds the queue.
+  struct Candidate {
+    uint32_t min_id;
+    uint32_t node;
+    bool is_word;
+  };
+  std::array<Candidate, kMaxCompletions + 1> pending;
+  size_t pending_size = 0;
+  size_t found = 0;
+
+  const auto push = [&](Candidate candidate) {
+    const size_t capacity = limit - found;
+    pending_size = std::min(pending_size, capacity);
+    if (pending_size == capacity && candidate.min_id >= pending[pending_size - 1].min_id) return;
+
+    size_t position = pending_size;
+    for (; position > 0 && pending[position - 1].min_id > candidate.min_id; --position) {
+      pending[position] = pending[position - 1];
+    }
+    pending[position] = candidate;
+    pending_size = std::min(pending_size + 1, capacity);
+  };
+
+  push(Candidate{.min_id = subtree_min_ids_[prefix_node], .node = prefix_node, .is_word = false});
+
+  while (pending_size > 0 && found < limit) {
+    const Candidate candidate = pending[0];
+    std::copy(pending.begin() + 1, pending.begin() + pending_size, pending.begin());
+    --pending_size;
+
+    if (candidate.min_id == kNoWord) break;
+
+    if (candidate.is_word) {
+      out[found++] = candidate.min_id;
+      continue;
+    }
+
+    if (values_[candidate.node] != kNoWord) {
+      push(Candidate{.min_id = values_[candidate.node], .node = candidate.node, .is_word = true});
+    }
+    for (uint32_t child = child_offsets_[candidate.node]; child < child_offsets_[candidate.node + 1]; ++child) {
+      push(Candidate{.min_id = subtree_min_ids_[child], .node = child, .is_word = false});
+    }
+  }
+
+  return found;
+}
+
+std::pmr::vector<WordTrie::Match> WordTrie::FindWithinDistance(std::string_view word, size_t max_distance, size_t limit,
+                                                               std::pmr::memory_resource* resource) const {
+  std::pmr::vector<Match> matches(resource);
+  if (Empty() || limit == 0) return matches;
+
+  // Distances are stored in bytes, and no query needs more edits than it has code points
+  max_distance = std::min(max_distance, kMaxQueryLength);
+  matches.reserve(limit);
+
+  SearchContext context{.max_distance = max_distance, .limit = limit, .matches = matches};
+  for (size_t index = 0; index < word.size();) {
+    if (context.query_length == kMaxQueryLength) return matches;
+    context.query[context.query_length++] = utils::utf8::DecodeCodePoint(word, index);
+    index += std::max(1, utils::utf8::CharLen(word, index));
+  }
+
+  for (size_t j = 0; j <= context.query_length; ++j) {
+    context.rows[0][j] = static_cast<uint8_t>(std::min(j, max_distance + 1));
+  }
+
+  Search(context, 0, 0);
+  return matches;
+}
+
+void WordTrie::Search(SearchContext& context, uint32_t node, size_t depth) const {
+  // Only cells within max_distance of the diagonal can stay within max_distance (Ukkonen's band);
+  // the cells just outside it hold a sentinel so that the next row reads them as too far
+  const size_t row_index = depth + 1;
+  const size_t max_distance = context.max_distance;
+  const size_t query_length = context.query_length;
+  const size_t band_begin = row_index > max_distance ? row_index - max_distance : 0;
+  const size_t band_end = std::min(query_length, row_index + max_distance);
+
+  // Paths longer than the query by more than max_distance can't match
+  if (band_begin > band_end || row_index >= context.rows.size()) return;
+
+  const auto outside = static_cast<uint8_t>(max_distance + 1);
+  const auto& prev_row = context.rows[depth];
+  auto& row = context.rows[row_index];
+
+  for (uint32_t child = child_offsets_[node]; child < child_offsets_[node + 1]; ++child) {
+    const char32_t label = labels_[child];
+
+    uint8_t row_min = outside;
+    if (band_begin == 0) {
+      row[0] = static_cast<uint8_t>(row_index);
+      row_min = row[0];
+    } else {
+      row[band_begin - 1] = outside;
+    }
+
+    for (size_t j = std::max<size_t>(band_begin, 1); j <= band_end; ++j) {
+      const uint8_t substitution = prev_row[j - 1] + (context.query[j - 1] != label ? 1 : 0);
+      const uint8_t deletion = prev_row[j] + 1;
+      const uint8_t insertion = row[j - 1] + 1;
+      row[j] = std::min({substitution, deletion, insertion, outside});
+      row_min = std::min(row_min, row[j]);
+    }
+
+    if (band_end < query_length) row[band_end + 1] = outside;
+
+    if (row_min > max_distance) continue;
+
+    if (values_[child] != kNoWord && band_end == query_length && row[query_length] <= max_distance) {
+      context.AddMatch(Match{.word_id = values_[child], .distance = row[query_length]});
+    }
+
+    Search(context, child, depth + 1);
+  }
+}
+
+}  // namespace contexto
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <pch.hpp>
+
+namespace contexto {
+
+// Immutable code point trie laid out in breadth-first order: the children of every node are stored
+// contiguously and the children of consecutive nodes follow each other, so a single offsets array
+// describes the whole tree. Every node costs 16 bytes and traversal touches sequential memory.
+// Word ids double as priorities: prefix search returns the lowest ids first.
+class WordTrie {
+public:
+  static constexpr uint32_t kNoWord = std::numeric_limits<uint32_t>::max();
+
+  // Longest query (in code points) accepted by the fuzzy search
+  static constexpr size_t kMaxQueryLength = 64;
+
+  // Most words a single prefix search returns
+  static constexpr size_t kMaxCompletions = 32;
+
+  struct Match {
+    uint32_t word_id = kNoWord;
+    uint8_t distance = 0;
+  };
+
+  WordTrie() = default;
+  WordTrie(const WordTrie&) = delete;
+  WordTrie(WordTrie&&) noexcept = default;
+  ~WordTrie() = default;
+
+  // Builds the trie from unique UTF-8 keys, each mapped to a word id
+  void Build(std::vector<std::pair<std::string_view, uint32_t>> words);
+
+  // Words within max_distance Levenshtein edits (in code points) of the query, closest first and
+  // lower ids first among equally close ones. The result is allocated from resource.
+  std::pmr::vector<Match> FindWithinDistance(
+      std::string_view word, size_t max_distance, size_t limit,
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const;
+
+  // Writes the lowest ids of the words starting with prefix into out, in ascending order, and returns
+  // their count. At most min(out.size(), kMaxCompletions) ids are written; nothing is allocated.
+  size_t FindWithPrefix(std::string_view prefix, std::span<uint32_t> out) const;
+
+  WordTrie& operator=(const WordTrie&) = delete;
+  WordTrie& operator=(WordTrie&&) noexcept = default;
+
+  size_t NodeCount() const noexcept { return labels_.size(); }
+  bool Empty() const noexcept { return labels_.size() <= 1; }
+
+  size_t MemoryUsage() const noexcept {
+    return labels_.capacity() * sizeof(char32_t) + child_offsets_.capacity() * sizeof(uint32_t) +
+           values_.capacity() * sizeof(uint32_t) + subtree_min_ids_.capacity() * sizeof(uint32_t);
+  }
+
+private:
+  struct SearchContext;
+
+  void Search(SearchContext& context, uint32_t node, size_t depth) const;
+  uint32_t FindNode(std::string_view prefix) const;
+
+  // Node 0 is the root; children of node i are [child_offsets_[i], child_offsets_[i + 1])
+  std::vector<char32_t> labels_;
+  std::vector<uint32_t> child_offsets_;
+  std::vector<uint32_t> values_;
+
+  // Lowest word id in the subtree of every node, kNoWord for the root of an empty trie
+  std::vector<uint32_t> subtree_min_ids_;
+};
+
+}  // namespace contexto
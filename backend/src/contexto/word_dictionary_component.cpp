@@ -3,8 +3,10 @@
 
 #include <userver/components/component_config.hpp>
 #include <userver/components/component_context.hpp>
+#include <userver/components/statistics_storage.hpp>
 #include <userver/logging/log.hpp>
 #include <userver/utils/assert.hpp>
+#include <userver/utils/statistics/writer.hpp>
 #include <userver/yaml_config/merge_schemas.hpp>
 
 namespace contexto {
@@ -21,9 +23,13 @@ WordDictionaryComponent::WordDictionaryComponent(const userver::components::Comp
     config.HasMember("max-dictionary-words") ? config["max-dictionary-words"].As<size_t>() : 100000;
 
   LOG_INFO() << "Initializing word embeddings with max dictionary words: " << max_dictionary_words_;
+  LOG_INFO() << "SIMD kernels selected for this CPU: " << utils::cpu::ToString(utils::cpu::ActiveIsa());
 
   // Load embeddings using the filter component
+  const auto embeddings_load_start = std::chrono::steady_clock::now();
   bool loaded = dictionary_.LoadFromVectorFile(embeddings_path, dictionary_filter_, true);
+  embeddings_load_duration_ = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - embeddings_load_start);
   if (!loaded || dictionary_.EmbeddingsSize() == 0) {
     LOG_ERROR() << "Failed to load word embeddings dictionary";
     throw std::runtime_error("Failed to initialize word dictionary");
@@ -31,10 +37,37 @@ WordDictionaryComponent::WordDictionaryComponent(const userver::components::Comp
     LOG_INFO() << "Successfully loaded embeddings with " << dictionary_.EmbeddingsSize() << " words";
   }
 
+  const auto reduction_config = config["embedding-reduction"];
+  const auto method_name = reduction_config["method"].As<std::string>("none");
+  const auto method = ParseProjectionMethod(method_name);
+  if (!method) {
+    throw std::runtime_error("Unknown embedding reduction method '" + method_name + "'");
+  }
+
+  EmbeddingReductionOptions reduction_options{
+      .method = *method,
+      .dimension = reduction_config["dimension"].As<size_t>(128),
+      .fit_samples = reduction_config["fit-samples"].As<size_t>(20000),
+      .report_dimensions = reduction_config["report-dimensions"].As<std::vector<size_t>>(std::vector<size_t>{}),
+      .evaluation = {.queries = reduction_config["evaluation-queries"].As<size_t>(100),
+                     .candidates = reduction_config["evaluation-candidates"].As<size_t>(20000),
+                     .top_k = reduction_config["evaluation-top-k"].As<size_t>(100)},
+  };
+
+  const auto reduction_quality = dictionary_.ReduceDimensions(reduction_options);
+  const auto chosen_quality = std::ranges::find(reduction_quality, reduction_options.dimension,
+                                                &ProjectionQuality::dimension);
+  if (chosen_quality != reduction_quality.end()) {
+    reduction_quality_ = *chosen_quality;
+  }
+
   // Load dedicated dictionary if specified
   if (config.HasMember("dictionary-path")) {
     const auto dictionary_path = config["dictionary-path"].As<std::string>();
+    const auto dictionary_load_start = std::chrono::steady_clock::now();
     bool dictionary_loaded = dictionary_.LoadDictionary(dictionary_path, dictionary_filter_, max_dictionary_words_);
+    dictionary_load_duration_ = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - dictionary_load_start);
 
     if (!dictionary_loaded) {
       LOG_WARNING() << "Failed to load dedicated dictionary from " << dictionary_path
@@ -43,19 +76,41 @@ WordDictionaryComponent::WordDictionaryComponent(const userver::components::Comp
   }
 
   LOG_INFO() << "Dictionary loaded with " << dictionary_.DictionarySize() << " words";
+
+  std::vector<double> type_weights;
+  for (const auto& sampling : dictionary_filter_.GetTargetSampling()) {
+    type_weights.push_back(sampling.weight);
+  }
+  type_sampler_ = utils::AliasTable(type_weights);
+
+  // The dictionary is immutable after loading, so its footprint is computed once
+  memory_usage_ = dictionary_.GetMemoryUsage();
+
+  statistics_holder_ =
+      context.FindComponent<userver::components::StatisticsStorage>().GetStorage().RegisterWriter(
+          "contexto.dictionary", [this](userver::utils::statistics::Writer& writer) { WriteStatistics(writer); });
 }
 
+WordDictionaryComponent::~WordDictionaryComponent() { statistics_holder_.Unregister(); }
+
 const models::DictionaryWord* WordDictionaryComponent::GenerateNewTargetWord() const {
   if (dictionary_filter_.HasPreferredDictionaryTypes()) {
-    // Select a random type from the preferred dictionary types
     const auto& preferred_types = dictionary_filter_.GetDictionaryPreferredTypes();
-    std::uniform_int_distribution<size_t> dist(0, preferred_types.size() - 1);
-    return dictionary_.GetRandomWordByType(preferred_types[dist(rng_)]);
+    return dictionary_.GetRandomWordByType(preferred_types[type_sampler_(utils::ThreadLocalRng())]);
   } else {
     return dictionary_.GetRandomWord();
   }
 }
 
+const models::DictionaryWord* WordDictionaryComponent::SelectTargetWord(uint64_t key) const {
+  if (dictionary_filter_.HasPreferredDictionaryTypes()) {
+    // The word is drawn from a remix of the key, so it doesn't depend on the bits that picked the type
+    const auto& preferred_types = dictionary_filter_.GetDictionaryPreferredTypes();
+    return dictionary_.GetWordByKey(key, preferred_types[type_sampler_.Sample(key)]);
+  }
+  return dictionary_.GetWordByKey(key);
+}
+
 std::optional<int> WordDictionaryComponent::CalculateRank(std::string_view guessed_word,
                                                           std::string_view target_word) const {
   if (!models::WordHasPOS(target_word)) {
@@ -63,37 +118,31 @@ std::optional<int> WordDictionaryComponent::CalculateRank(std::string_view guess
     return std::nullopt;
   }
 
-  const std::string_view target_only_word = models::GetWordFromWordWithPOS(target_word);
+  const auto target_index = dictionary_.FindWordIndex(target_word);
+  const auto guess_index = dictionary_.FindWordIndex(guessed_word);
+  if (!target_index || !guess_index) {
+    LOG_ERROR() << "Failed to calculate similarity of '" << guessed_word << "' and '" << target_word << "'";
+    return std::nullopt;
+  }
 
-  // If the words match (ignoring POS), it's rank 1
-  if (guessed_word == target_only_word) return 1;
+  return CalculateRank(*guess_index, models::WordHasPOS(guessed_word), *target_index);
+}
 
-  // Calculate cosine similarity
-  float cosine_sim = 0.0f;
-  if (models::WordHasPOS(guessed_word)) {
-    cosine_sim = dictionary_.CalculateSimilarity(guessed_word, target_word);
-  } else {
-    // Find best POS variant
-    float best_sim = -1.0f;
-    const auto indices = dictionary_.GetIndicesToWordPOSVariations(guessed_word);
-    for (const size_t index : indices) {
-      const models::DictionaryWord& dictionary_word = dictionary_.GetWordWithEmbeddingByIndex(index);
-      const float curr_sim = dictionary_.CalculateSimilarity(dictionary_word.word_with_pos, target_word);
-      if (curr_sim > best_sim) {
-        best_sim = curr_sim;
-      }
-    }
-    cosine_sim = best_sim;
-  }
+int WordDictionaryComponent::CalculateRank(size_t guess_index, bool guess_has_pos, size_t target_index) const {
+  // If the words match (ignoring POS, case and ё/е spelling), it's rank 1
+  if (dictionary_.FoldedEqual(guess_index, guess_has_pos, target_index)) return 1;
 
-  if (cosine_sim == -1.0f) {
-    LOG_ERROR() << "Failed to calculate similarity";
-    return std::nullopt;
-  }
+  // Calculate cosine similarity, a bare word by its best POS variant
+  const float cosine_sim = guess_has_pos
+                               ? dictionary_.CalculateSimilarity(guess_index, target_index)
+                               : dictionary_.CalculateBestVariantSimilarity(dictionary_.GetPOSVariants(guess_index),
+                                                                            target_index);
 
-  const size_t prefix_length = utils::utf8::CommonPrefixLength(guessed_word, target_only_word);
+  // Only prefixes of up to 5 characters, or shorter than 4, change the result, so the precomputed
+  // 8-character prefixes give exact ranks
+  const size_t prefix_length = dictionary_.CommonPrefixLength(guess_index, guess_has_pos, target_index);
   const size_t min_word_length =
-      std::min(utils::utf8::CharCount(guessed_word), utils::utf8::CharCount(target_only_word));
+      std::min(dictionary_.GetCharCount(guess_index, guess_has_pos), dictionary_.GetCharCount(target_index, false));
 
   // Longer prefixes relative to word length indicate likely shared roots
   // Calculate as a ratio but with higher weight for longer prefixes (up to 5 chars)
@@ -158,7 +207,10 @@ std::optional<int> WordDictionaryComponent::CalculateRank(std::string_view guess
     rank = std::min(rank, 150);
   }
 
-  LOG_DEBUG() << "Word: " << guessed_word << ", Target: " << target_only_word << ", Cosine: " << cosine_sim
+  LOG_DEBUG() << "Word: "
+              << (guess_has_pos ? dictionary_.GetWordWithEmbeddingByIndex(guess_index).word_with_pos
+                                : dictionary_.GetWord(guess_index))
+              << ", Target: " << dictionary_.GetWord(target_index) << ", Cosine: " << cosine_sim
               << ", Prefix score: " << prefix_score << ", Morph bonus: " << morphological_bonus
               << ", Combined: " << combined_similarity << ", Shared root: " << (likely_shared_root ? "yes" : "no")
               << ", Final rank: " << rank;
@@ -194,6 +246,38 @@ std::vector<models::Word> WordDictionaryComponent::GetSimilarWords(std::string_v
   return similar_words;
 }
 
+void WordDictionaryComponent::WriteStatistics(userver::utils::statistics::Writer& writer) const {
+  writer["embeddings"] = dictionary_.EmbeddingsSize();
+  writer["embedding-dimension"] = dictionary_.EmbeddingDimension();
+  writer["dictionary-words"] = dictionary_.DictionarySize();
+
+  auto bytes = writer["bytes"];
+  bytes["embeddings"] = memory_usage_.embeddings;
+  bytes["word-arena"] = memory_usage_.word_arena;
+  bytes["words"] = memory_usage_.words;
+  bytes["word-with-pos-index"] = memory_usage_.word_with_pos_index;
+  bytes["word-to-words-with-pos"] = memory_usage_.word_to_words_with_pos;
+  bytes["folded-index"] = memory_usage_.folded_index;
+  bytes["spelling-trie"] = memory_usage_.spelling_trie;
+  bytes["target-samplers"] = memory_usage_.target_samplers;
+  bytes["word-metadata"] = memory_usage_.word_metadata;
+
+  auto load_duration = writer["load-duration-ms"];
+  load_duration["embeddings"] = embeddings_load_duration_.count();
+  load_duration["dictionary"] = dictionary_load_duration_.count();
+
+  if (reduction_quality_) {
+    auto reduction = writer["reduction"];
+    reduction["spearman"] = reduction_quality_->spearman;
+    reduction["top-k-overlap"] = reduction_quality_->top_k_overlap;
+    reduction["explained-variance"] = reduction_quality_->explained_variance;
+  }
+
+  // Instruction set the similarity and UTF-8 kernels were dispatched to on this host
+  writer["cpu-dispatch"].ValueWithLabels(
+      1, userver::utils::statistics::LabelView("isa", utils::cpu::ToString(utils::cpu::ActiveIsa())));
+}
+
 userver::yaml_config::Schema WordDictionaryComponent::GetStaticConfigSchema() {
   return userver::yaml_config::MergeSchemas<userver::components::LoggableComponentBase>(R"(
 type: object
@@ -211,6 +295,41 @@ properties:
     type: integer
     description: Maximum number of words to load from the dictionary file
     defaultDescription: 0
+  embedding-reduction:
+    type: object
+    description: Optional projection of the embeddings to fewer dimensions at load time
+    additionalProperties: false
+    properties:
+      method:
+        type: string
+        description: none, pca (principal components) or random (Gaussian random projection)
+        defaultDescription: none
+      dimension:
+        type: integer
+        description: Dimension the embeddings are reduced to
+        defaultDescription: 128
+      fit-samples:
+        type: integer
+        description: Maximum number of embeddings PCA is fitted on
+        defaultDescription: 20000
+      report-dimensions:
+        type: array
+        description: Additional dimensions whose rank quality is logged, to help choose the dimension
+        items:
+          type: integer
+          description: Dimension to evaluate
+      evaluation-queries:
+        type: integer
+        description: Number of sampled query words the rank quality is averaged over
+        defaultDescription: 100
+      evaluation-candidates:
+        type: integer
+        description: Number of sampled words every query is ranked against
+        defaultDescription: 20000
+      evaluation-top-k:
+        type: integer
+        description: Size of the neighbour lists compared for the top-k overlap
+        defaultDescription: 100
 )");
 }
 
@@ -5,6 +5,7 @@
 
 #include <userver/components/loggable_component_base.hpp>
 #include <userver/engine/shared_mutex.hpp>
+#include <userver/utils/statistics/entry.hpp>
 
 namespace contexto {
 
@@ -17,16 +18,38 @@ public:
 
   WordDictionaryComponent(const userver::components::ComponentConfig& config,
                           const userver::components::ComponentContext& context);
+  ~WordDictionaryComponent() override;
 
   bool ValidateWord(std::string_view word) const {
     if (word.empty()) return false;
     return dictionary_.ContainsWord(word);
   }
 
+  // See WordDictionary::FindCanonicalWord
+  std::string_view ResolveWord(std::string_view word) const { return dictionary_.FindCanonicalWord(word); }
+
+  // See WordDictionary::FindSimilarSpellings
+  std::pmr::vector<SpellingSuggestion> SuggestSpellings(std::string_view word, size_t max_distance, size_t limit,
+                                                        std::pmr::memory_resource& resource) const {
+    return dictionary_.FindSimilarSpellings(word, max_distance, limit, &resource);
+  }
+
+  // See WordDictionary::FindCompletions
+  size_t CompleteWord(std::string_view prefix, std::span<std::string_view> out) const {
+    return dictionary_.FindCompletions(prefix, out);
+  }
+
   const models::DictionaryWord* GenerateNewTargetWord() const;
 
+  // Deterministic counterpart of GenerateNewTargetWord, the same key selects the same target on every replica
+  const models::DictionaryWord* SelectTargetWord(uint64_t key) const;
+
   std::optional<int> CalculateRank(std::string_view guessed_word, std::string_view target_word) const;
 
+  // String-free counterpart for resolved words: a bare guess (guess_has_pos = false) is scored by its best POS
+  // variant, guess_index being any of them
+  int CalculateRank(size_t guess_index, bool guess_has_pos, size_t target_index) const;
+
   std::vector<models::Word> GetSimilarWords(std::string_view word, std::string_view target_word) const;
 
   const WordDictionary& GetDictionary() const noexcept { return dictionary_; }
@@ -34,6 +57,8 @@ public:
   static userver::yaml_config::Schema GetStaticConfigSchema();
 
 private:
+  void WriteStatistics(userver::utils::statistics::Writer& writer) const;
+
   static constexpr models::WordType StringToWordType(std::string_view str) noexcept {
     if (str == "noun") return models::WordType::kNoun;
     if (str == "verb") return models::WordType::kVerb;
@@ -59,7 +84,14 @@ private:
   size_t max_dictionary_words_ = 0;
   const DictionaryFilterComponent& dictionary_filter_;
 
-  mutable std::mt19937 rng_{std::random_device{}()};
+  // Picks one of the preferred dictionary types by its target-sampling weight
+  utils::AliasTable type_sampler_;
+
+  DictionaryMemoryUsage memory_usage_;
+  std::optional<ProjectionQuality> reduction_quality_;
+  std::chrono::milliseconds embeddings_load_duration_{0};
+  std::chrono::milliseconds dictionary_load_duration_{0};
+  userver::utils::statistics::Entry statistics_holder_;
 };
 
 }  // namespace contexto
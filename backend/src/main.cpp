@@ -1,14 +1,27 @@
+#include "contexto/analytics_handler.hpp"
+#include "contexto/closest_words_handler.hpp"
+#include "contexto/complete_handler.hpp"
+#include "contexto/cors_component.hpp"
+#include "contexto/daily_puzzle_component.hpp"
+#include "contexto/game_event_log.hpp"
 #include "contexto/give_up_handler.hpp"
+#include "contexto/guess_analytics.hpp"
 #include "contexto/guess_handler.hpp"
+#include "contexto/guesses_handler.hpp"
 #include "contexto/new_game_handler.hpp"
+#include "contexto/rank_table_cache.hpp"
 #include "contexto/session_manager.hpp"
+#include "contexto/target_difficulty_component.hpp"
+#include "contexto/task_processor_monitor.hpp"
 #include "contexto/word_dictionary_component.hpp"
 #include "contexto/dictionary_filter_component.hpp"
+#include "contexto/game_pool_component.hpp"
 
 #include <userver/clients/dns/component.hpp>
 #include <userver/clients/http/component.hpp>
 #include <userver/components/minimal_server_component_list.hpp>
 #include <userver/server/handlers/ping.hpp>
+#include <userver/server/handlers/server_monitor.hpp>
 #include <userver/server/handlers/tests_control.hpp>
 #include <userver/testsuite/testsuite_support.hpp>
 #include <userver/utils/daemon_run.hpp>
@@ -18,12 +31,25 @@ int main(int argc, char* argv[]) {
                             .Append<userver::components::TestsuiteSupport>("testsuite-support")
                             .Append<userver::components::HttpClient>()
                             .Append<userver::server::handlers::Ping>("ping")
+                            .Append<userver::server::handlers::ServerMonitor>()
                             .Append<userver::clients::dns::Component>("dns-client")
+                            .Append<contexto::CorsComponent>()
                             .Append<contexto::SessionManager>()
                             .Append<contexto::NewGameHandler>()
                             .Append<contexto::GuessHandler>()
+                            .Append<contexto::GuessesHandler>()
+                            .Append<contexto::ClosestWordsHandler>()
                             .Append<contexto::GiveUpHandler>()
+                            .Append<contexto::CompleteHandler>()
                             .Append<contexto::WordDictionaryComponent>()
+                            .Append<contexto::DailyPuzzleComponent>()
+                            .Append<contexto::GamePoolComponent>()
+                            .Append<contexto::TargetDifficultyComponent>()
+                            .Append<contexto::RankTableCache>()
+                            .Append<contexto::TaskProcessorMonitor>()
+                            .Append<contexto::GameEventLog>()
+                            .Append<contexto::GuessAnalytics>()
+                            .Append<contexto::AnalyticsHandler>()
                             .Append<contexto::DictionaryFilterComponent>();
 
   component_list.Append<userver::server::handlers::TestsControl>("tests-control");
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+namespace utils {
+
+// Count-Min sketch over 64-bit key hashes. Counters are relaxed atomics, so Add is depth fetch_adds and never
+// blocks concurrent writers or readers. Estimate never undercounts; it overcounts by at most e * total / width
+// with probability 1 - e^-depth.
+class CountMinSketch final {
+public:
+  // Width is rounded up to a power of two
+  CountMinSketch(size_t width, size_t depth)
+      : width_(std::bit_ceil(width < 2 ? size_t{2} : width)),
+        depth_(depth < 1 ? size_t{1} : depth),
+        counters_(std::make_unique<std::atomic<uint32_t>[]>(width_ * depth_)) {}
+
+  CountMinSketch(const CountMinSketch&) = delete;
+  CountMinSketch& operator=(const CountMinSketch&) = delete;
+
+  void Add(uint64_t hash, uint32_t count = 1) noexcept {
+    for (size_t row = 0; row < depth_; ++row) {
+      counters_[Cell(hash, row)].fetch_add(count, std::memory_order_relaxed);
+    }
+  }
+
+  uint32_t Estimate(uint64_t hash) const noexcept {
+    uint32_t estimate = std::numeric_limits<uint32_t>::max();
+    for (size_t row = 0; row < depth_; ++row) {
+      estimate = std::min(estimate, counters_[Cell(hash, row)].load(std::memory_order_relaxed));
+    }
+    return estimate;
+  }
+
+  size_t Width() const noexcept { return width_; }
+  size_t Depth() const noexcept { return depth_; }
+  size_t MemoryUsage() const noexcept { return width_ * depth_ * sizeof(uint32_t); }
+
+private:
+  // Rows are indexed by double hashing, the key is mixed first so that sequential keys spread over the row
+  size_t Cell(uint64_t hash, size_t row) const noexcept {
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    const uint64_t h1 = hash & 0xffffffffULL;
+    const uint64_t h2 = (hash >> 32) | 1;
+    return row * width_ + ((h1 + row * h2) & (width_ - 1));
+  }
+
+  const size_t width_;
+  const size_t depth_;
+  const std::unique_ptr<std::atomic<uint32_t>[]> counters_;
+};
+
+}  // namespace utils
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+// Kernels are compiled for several instruction sets in one binary and the best one supported by the
+// host is picked at runtime, so a single build runs on every x86-64 CPU.
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define UTILS_CPU_DISPATCH 1
+#define UTILS_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define UTILS_TARGET_AVX512 __attribute__((target("avx512f,avx512bw,avx2,fma")))
+#else
+#define UTILS_CPU_DISPATCH 0
+#endif
+
+namespace utils::cpu {
+
+// Instruction set levels with dedicated kernels, from lowest to highest
+enum class Isa : uint8_t {
+  kScalar,
+  kSse2,    // x86-64 baseline
+  kAvx2,    // AVX2 + FMA (Haswell and later)
+  kAvx512,  // AVX-512 F + BW (Skylake-SP and later)
+};
+
+static constexpr std::string_view ToString(Isa isa) noexcept {
+  switch (isa) {
+    case Isa::kScalar:
+      return "scalar";
+    case Isa::kSse2:
+      return "sse2";
+    case Isa::kAvx2:
+      return "avx2";
+    case Isa::kAvx512:
+      return "avx512";
+  }
+  return "unknown";
+}
+
+static inline Isa DetectIsa() noexcept {
+#if UTILS_CPU_DISPATCH
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) return Isa::kAvx512;
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return Isa::kAvx2;
+  return Isa::kSse2;
+#else
+  return Isa::kScalar;
+#endif
+}
+
+// Detected once; every dispatching kernel branches on this value
+inline Isa ActiveIsa() noexcept {
+  static const Isa isa = DetectIsa();
+  return isa;
+}
+
+static inline bool IsSupported(Isa isa) noexcept { return isa <= ActiveIsa(); }
+
+}  // namespace utils::cpu
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstddef>
+
+#include "cpu_dispatch.hpp"
+
+#if UTILS_CPU_DISPATCH
+#include <immintrin.h>
+#endif
+
+namespace utils::simd {
+
+namespace detail {
+
+static inline float DotScalar(const float* lhs, const float* rhs, size_t size) noexcept {
+  // Independent accumulators let the compiler vectorize and pipeline the loop
+  float sums[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+  size_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    sums[0] += lhs[i] * rhs[i];
+    sums[1] += lhs[i + 1] * rhs[i + 1];
+    sums[2] += lhs[i + 2] * rhs[i + 2];
+    sums[3] += lhs[i + 3] * rhs[i + 3];
+  }
+  for (; i < size; ++i) {
+    sums[0] += lhs[i] * rhs[i];
+  }
+  return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+}
+
+#if UTILS_CPU_DISPATCH
+static inline float DotSse2(const float* lhs, const float* rhs, size_t size) noexcept {
+  __m128 sum0 = _mm_setzero_ps();
+  __m128 sum1 = _mm_setzero_ps();
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(lhs + i), _mm_loadu_ps(rhs + i)));
+    sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(lhs + i + 4), _mm_loadu_ps(rhs + i + 4)));
+  }
+
+  alignas(16) float lanes[4];
+  _mm_store_ps(lanes, _mm_add_ps(sum0, sum1));
+  float sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+  for (; i < size; ++i) {
+    sum += lhs[i] * rhs[i];
+  }
+  return sum;
+}
+
+UTILS_TARGET_AVX2 static inline float HorizontalSum(__m256 sum) noexcept {
+  __m128 half = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+  half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+  half = _mm_add_ss(half, _mm_shuffle_ps(half, half, 1));
+  return _mm_cvtss_f32(half);
+}
+
+UTILS_TARGET_AVX2 static inline float DotAvx2(const float* lhs, const float* rhs, size_t size) noexcept {
+  // Four accumulators hide the FMA latency
+  __m256 sum0 = _mm256_setzero_ps();
+  __m256 sum1 = _mm256_setzero_ps();
+  __m256 sum2 = _mm256_setzero_ps();
+  __m256 sum3 = _mm256_setzero_ps();
+  size_t i = 0;
+  for (; i + 32 <= size; i += 32) {
+    sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(lhs + i), _mm256_loadu_ps(rhs + i), sum0);
+    sum1 = _mm256_fmadd_ps(_mm256_loadu_ps(lhs + i + 8), _mm256_loadu_ps(rhs + i + 8), sum1);
+    sum2 = _mm256_fmadd_ps(_mm256_loadu_ps(lhs + i + 16), _mm256_loadu_ps(rhs + i + 16), sum2);
+    sum3 = _mm256_fmadd_ps(_mm256_loadu_ps(lhs + i + 24), _mm256_loadu_ps(rhs + i + 24), sum3);
+  }
+  for (; i + 8 <= size; i += 8) {
+    sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(lhs + i), _mm256_loadu_ps(rhs + i), sum0);
+  }
+
+  float result = HorizontalSum(_mm256_add_ps(_mm256_add_ps(sum0, sum1), _mm256_add_ps(sum2, sum3)));
+  for (; i < size; ++i) {
+    result += lhs[i] * rhs[i];
+  }
+  return result;
+}
+
+UTILS_TARGET_AVX512 static inline float DotAvx512(const float* lhs, const float* rhs, size_t size) noexcept {
+  __m512 sum0 = _mm512_setzero_ps();
+  __m512 sum1 = _mm512_setzero_ps();
+  size_t i = 0;
+  for (; i + 32 <= size; i += 32) {
+    sum0 = _mm512_fmadd_ps(_mm512_loadu_ps(lhs + i), _mm512_loadu_ps(rhs + i), sum0);
+    sum1 = _mm512_fmadd_ps(_mm512_loadu_ps(lhs + i + 16), _mm512_loadu_ps(rhs + i + 16), sum1);
+  }
+  for (; i + 16 <= size; i += 16) {
+    sum0 = _mm512_fmadd_ps(_mm512_loadu_ps(lhs + i), _mm512_loadu_ps(rhs + i), sum0);
+  }
+
+  // The remainder is loaded with a lane mask instead of a scalar loop
+  if (i < size) {
+    const auto mask = static_cast<__mmask16>((1u << (size - i)) - 1);
+    sum1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, lhs + i), _mm512_maskz_loadu_ps(mask, rhs + i), sum1);
+  }
+
+  // Halved by hand: GCC's _mm512_reduce_add_ps and the unmasked extracts start from an undefined register and
+  // warn about it. The halves are extracted as doubles, since the float variant needs AVX512DQ.
+  const __m512d sum = _mm512_castps_pd(_mm512_add_ps(sum0, sum1));
+  const __m256 lower = _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xFF, sum, 0));
+  const __m256 upper = _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xFF, sum, 1));
+  return HorizontalSum(_mm256_add_ps(lower, upper));
+}
+#endif
+
+}  // namespace detail
+
+// Dot product of two float arrays with the widest kernel the CPU supports. Kernels sum in different
+// orders, so results may differ between hosts in the last bits.
+static inline float Dot(const float* lhs, const float* rhs, size_t size) noexcept {
+#if UTILS_CPU_DISPATCH
+  switch (cpu::ActiveIsa()) {
+    case cpu::Isa::kAvx512:
+      return detail::DotAvx512(lhs, rhs, size);
+    case cpu::Isa::kAvx2:
+      return detail::DotAvx2(lhs, rhs, size);
+    default:
+      return detail::DotSse2(lhs, rhs, size);
+  }
+#else
+  return detail::DotScalar(lhs, rhs, size);
+#endif
+}
+
+}  // namespace utils::simd
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace utils {
+
+inline constexpr uint64_t kFnv1aOffsetBasis = 0xcbf29ce484222325ull;
+
+// 64-bit FNV-1a. Unlike std::hash it is the same in every build and standard library, so its values can be
+// stored on disk or compared between replicas. Passing a previous result as hash continues it.
+constexpr uint64_t Fnv1a(std::string_view bytes, uint64_t hash = kFnv1aOffsetBasis) noexcept {
+  for (const char c : bytes) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 0x100000001b3ull;
+  }
+  return hash;
+}
+
+}  // namespace utils
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <span>
+#include <vector>
+
+namespace utils {
+
+// SplitMix64 finalizer: maps consecutive or otherwise related keys to unrelated 64-bit values
+constexpr uint64_t SplitMix64(uint64_t value) noexcept {
+  value += 0x9e3779b97f4a7c15ull;
+  value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+  value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+  return value ^ (value >> 31);
+}
+
+// Generator of the calling thread. Drawing from it never suspends, so a task can't migrate mid-draw.
+inline std::mt19937_64& ThreadLocalRng() {
+  thread_local std::mt19937_64 rng{std::random_device{}()};
+  return rng;
+}
+
+// Walker's alias table built with Vose's method: O(n) construction, then every draw from the weighted
+// distribution costs one column pick and one biased coin flip, independent of n.
+class AliasTable final {
+public:
+  AliasTable() = default;
+
+  // Negative weights count as zero; if all weights are zero the distribution is uniform
+  explicit AliasTable(std::span<const double> weights) : columns_(weights.size()) {
+    const size_t size = weights.size();
+    if (size == 0) return;
+
+    double total = 0.0;
+    for (const double weight : weights) total += std::max(weight, 0.0);
+
+    // Scaled so that the average column holds exactly 1
+    std::vector<double> scaled(size);
+    for (size_t i = 0; i < size; ++i) {
+      scaled[i] = total > 0.0 ? std::max(weights[i], 0.0) * static_cast<double>(size) / total : 1.0;
+    }
+
+    std::vector<uint32_t> small;
+    std::vector<uint32_t> large;
+    for (size_t i = 0; i < size; ++i) {
+      (scaled[i] < 1.0 ? small : large).push_back(static_cast<uint32_t>(i));
+    }
+
+    // Every underfull column is topped up by one overfull column, which becomes its alias
+    while (!small.empty() && !large.empty()) {
+      const uint32_t less = small.back();
+      small.pop_back();
+      const uint32_t more = large.back();
+
+      columns_[less] = Column{.threshold = ToThreshold(scaled[less]), .alias = more};
+      scaled[more] -= 1.0 - scaled[less];
+      if (scaled[more] < 1.0) {
+        large.pop_back();
+        small.push_back(more);
+      }
+    }
+
+    // Leftovers are full up to rounding error
+    for (const auto index : large) columns_[index] = Column{.threshold = kFull, .alias = index};
+    for (const auto index : small) columns_[index] = Column{.threshold = kFull, .alias = index};
+  }
+
+  // Deterministic draw from 64 uniformly distributed bits: the low half picks the column, the high half flips
+  // the coin. The same bits always select the same index.
+  size_t Sample(uint64_t bits) const noexcept {
+    const auto column = static_cast<size_t>(((bits & 0xffffffffull) * columns_.size()) >> 32);
+    const auto coin = bits >> 32;
+    const auto& entry = columns_[column];
+    return coin < entry.threshold ? column : entry.alias;
+  }
+
+  template <typename Generator>
+  size_t operator()(Generator& generator) const {
+    return Sample(std::uniform_int_distribution<uint64_t>{}(generator));
+  }
+
+  size_t Size() const noexcept { return columns_.size(); }
+  bool Empty() const noexcept { return columns_.empty(); }
+  size_t MemoryUsage() const noexcept { return columns_.capacity() * sizeof(Column); }
+
+private:
+  // The coin is a 32-bit integer, a column keeps its own index if the coin is below the threshold. Full columns
+  // are their own alias, so the coin doesn't matter for them.
+  static constexpr uint32_t kFull = std::numeric_limits<uint32_t>::max();
+
+  static uint32_t ToThreshold(double probability) noexcept {
+    const double scaled = std::clamp(probability, 0.0, 1.0) * 4294967296.0;
+    return scaled >= static_cast<double>(kFull) ? kFull : static_cast<uint32_t>(scaled);
+  }
+
+  struct Column {
+    uint32_t threshold = kFull;
+    uint32_t alias = 0;
+  };
+
+  std::vector<Column> columns_;
+};
+
+// Robert Floyd's algorithm: count distinct indices below population, uniformly, in count draws and without
+// a hash set. Indices come out in no particular order.
+template <typename Generator>
+std::vector<size_t> SampleWithoutReplacement(size_t population, size_t count, Generator& generator) {
+  std::vector<size_t> result;
+  if (count >= population) {
+    result.resize(population);
+    std::iota(result.begin(), result.end(), size_t{0});
+    return result;
+  }
+
+  result.reserve(count);
+  std::vector<bool> taken(population);
+  for (size_t upper = population - count; upper < population; ++upper) {
+    const size_t candidate = std::uniform_int_distribution<size_t>{0, upper}(generator);
+    const size_t chosen = taken[candidate] ? upper : candidate;
+    taken[chosen] = true;
+    result.push_back(chosen);
+  }
+  return result;
+}
+
+}  // namespace utils
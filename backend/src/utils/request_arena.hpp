@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+#include <userver/compiler/thread_local.hpp>
+
+namespace utils {
+
+// Bump allocator for the temporaries of one request: allocations are carved out of a slab and released all at
+// once when the arena is destroyed. Slabs are recycled through a small per-thread cache, so a request that stays
+// within its slab never reaches malloc. A slab is owned by one arena at a time rather than by the thread, since
+// coroutines may be suspended mid-request and resumed on another thread.
+class RequestArena final : public std::pmr::memory_resource {
+public:
+  static constexpr size_t kSlabSize = 16 * 1024;
+  static constexpr size_t kMaxCachedSlabs = 8;
+
+  RequestArena() : slab_(TakeSlab()), buffer_(slab_.get(), kSlabSize, &upstream_) {}
+
+  RequestArena(const RequestArena&) = delete;
+  RequestArena& operator=(const RequestArena&) = delete;
+
+  ~RequestArena() override;
+
+  // Allocations served by the arena, whether from the slab or from overflow blocks
+  size_t Allocations() const noexcept { return allocations_; }
+  size_t AllocatedBytes() const noexcept { return allocated_bytes_; }
+
+  // Blocks requested from the global heap once the slab is exhausted
+  size_t UpstreamAllocations() const noexcept { return upstream_.allocations; }
+
+private:
+  using Slab = std::unique_ptr<std::byte[]>;
+
+  // Forwards to the global heap and counts the blocks it hands out
+  struct CountingResource final : std::pmr::memory_resource {
+    size_t allocations = 0;
+
+    void* do_allocate(size_t bytes, size_t alignment) override {
+      ++allocations;
+      return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+      std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+  };
+
+  // A plain thread_local may be cached by the compiler across a coroutine switch, userver's wrapper is not
+  static auto& SlabCache() {
+    static userver::compiler::ThreadLocal cache = [] { return std::vector<Slab>{}; };
+    return cache;
+  }
+
+  static Slab TakeSlab() {
+    auto cache = SlabCache().Use();
+    if (cache->empty()) return std::make_unique_for_overwrite<std::byte[]>(kSlabSize);
+
+    Slab slab = std::move(cache->back());
+    cache->pop_back();
+    return slab;
+  }
+
+  void* do_allocate(size_t bytes, size_t alignment) override {
+    ++allocations_;
+    allocated_bytes_ += bytes;
+    return buffer_.allocate(bytes, alignment);
+  }
+
+  // Memory is only reclaimed when the arena goes away
+  void do_deallocate(void*, size_t, size_t) override {}
+
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+  Slab slab_;
+  CountingResource upstream_;
+  std::pmr::monotonic_buffer_resource buffer_;
+  size_t allocations_ = 0;
+  size_t allocated_bytes_ = 0;
+};
+
+inline RequestArena::~RequestArena() {
+  buffer_.release();
+  auto cache = SlabCache().Use();
+  if (cache->size() < kMaxCachedSlabs) cache->push_back(std::move(slab_));
+}
+
+}  // namespace utils
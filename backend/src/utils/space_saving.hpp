@@ -0,0 +1,65 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace utils {
+
+// Space-Saving heavy hitters (Metwally et al.): tracks at most capacity keys. An untracked key replaces the
+// one with the smallest count and inherits that count as its error, so count - error is a lower bound and
+// count an upper bound of the true frequency. Every key more frequent than total / capacity is tracked.
+// Not thread-safe.
+template <typename Key>
+class SpaceSaving final {
+public:
+  struct Entry {
+    Key key{};
+    uint64_t count = 0;
+    uint64_t error = 0;
+  };
+
+  explicit SpaceSaving(size_t capacity) : capacity_(capacity < 1 ? size_t{1} : capacity) {
+    entries_.reserve(capacity_);
+  }
+
+  // Linear scans beat a hash map plus stream summary for the few dozen entries this is used with
+  void Add(const Key& key, uint64_t count = 1) {
+    total_ += count;
+    for (auto& entry : entries_) {
+      if (entry.key == key) {
+        entry.count += count;
+        return;
+      }
+    }
+
+    if (entries_.size() < capacity_) {
+      entries_.push_back(Entry{.key = key, .count = count, .error = 0});
+      return;
+    }
+
+    auto& min_entry = *std::min_element(entries_.begin(), entries_.end(),
+                                        [](const Entry& lhs, const Entry& rhs) { return lhs.count < rhs.count; });
+    min_entry = Entry{.key = key, .count = min_entry.count + count, .error = min_entry.count};
+  }
+
+  // Tracked keys, most frequent first
+  std::vector<Entry> Top(size_t limit) const {
+    std::vector<Entry> top = entries_;
+    std::sort(top.begin(), top.end(), [](const Entry& lhs, const Entry& rhs) { return lhs.count > rhs.count; });
+    if (top.size() > limit) top.resize(limit);
+    return top;
+  }
+
+  const std::vector<Entry>& Entries() const noexcept { return entries_; }
+  uint64_t Total() const noexcept { return total_; }
+  size_t Capacity() const noexcept { return capacity_; }
+
+private:
+  size_t capacity_;
+  std::vector<Entry> entries_;
+  uint64_t total_ = 0;
+};
+
+}  // namespace utils
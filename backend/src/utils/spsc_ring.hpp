@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+namespace utils {
+
+// Bounded lock-free ring for exactly one producer thread and one consumer thread. Push and pop are a slot copy
+// plus one release store; head and tail live on separate cache lines so the two sides don't share one.
+template <typename T>
+class SpscRing final {
+  static_assert(std::is_trivially_copyable_v<T>, "Slots are copied without synchronization of their own");
+
+public:
+  // Capacity is rounded up to a power of two
+  explicit SpscRing(size_t capacity)
+      : capacity_(std::bit_ceil(capacity < 2 ? size_t{2} : capacity)),
+        mask_(capacity_ - 1),
+        slots_(std::make_unique<T[]>(capacity_)) {}
+
+  SpscRing(const SpscRing&) = delete;
+  SpscRing& operator=(const SpscRing&) = delete;
+
+  // Producer side; returns false if the ring is full
+  bool TryPush(const T& value) noexcept {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head - cached_tail_ == capacity_) {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+      if (head - cached_tail_ == capacity_) return false;
+    }
+
+    slots_[head & mask_] = value;
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side; returns false if the ring is empty
+  bool TryPop(T& value) noexcept {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail == cached_head_) {
+      cached_head_ = head_.load(std::memory_order_acquire);
+      if (tail == cached_head_) return false;
+    }
+
+    value = slots_[tail & mask_];
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Approximate when called concurrently with either side
+  size_t Size() const noexcept {
+    return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+  }
+
+  size_t Capacity() const noexcept { return capacity_; }
+
+private:
+  static constexpr size_t kCacheLine = 64;
+
+  const size_t capacity_;
+  const size_t mask_;
+  const std::unique_ptr<T[]> slots_;
+
+  // Each side caches the other side's index and rereads it only when the ring looks full or empty
+  alignas(kCacheLine) std::atomic<size_t> head_ = 0;
+  size_t cached_tail_ = 0;
+  alignas(kCacheLine) std::atomic<size_t> tail_ = 0;
+  size_t cached_head_ = 0;
+};
+
+}  // namespace utils
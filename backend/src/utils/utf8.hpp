@@ -1,9 +1,20 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <cassert>
+#include <cstdint>
+#include <span>
 #include <string>
 #include <string_view>
 
+#include "cpu_dispatch.hpp"
+
+#if UTILS_CPU_DISPATCH
+#include <immintrin.h>
+#endif
+
 namespace utils::utf8 {
 
 static constexpr bool IsContinuationByte(char ch) noexcept {
@@ -35,6 +46,21 @@ static constexpr int CharLen(std::string_view str, size_t index) noexcept {
   return -1;  // Invalid UTF-8 sequence
 }
 
+// Decodes the code point starting at index; the caller advances by CharLen(str, index).
+// Invalid or truncated sequences decode to the lead byte value.
+static constexpr char32_t DecodeCodePoint(std::string_view str, size_t index) noexcept {
+  const int len = CharLen(str, index);
+  const auto lead = static_cast<uint8_t>(str[index]);
+  if (len <= 1 || index + len > str.size()) return lead;
+
+  constexpr std::array<uint8_t, 5> LEAD_PAYLOAD_MASKS = {0x00, 0x7F, 0x1F, 0x0F, 0x07};
+  auto code_point = static_cast<char32_t>(lead & LEAD_PAYLOAD_MASKS[len]);
+  for (int i = 1; i < len; ++i) {
+    code_point = (code_point << 6) | (static_cast<uint8_t>(str[index + i]) & 0x3F);
+  }
+  return code_point;
+}
+
 static constexpr size_t CharCount(std::string_view str) noexcept {
   size_t count = 0;
   size_t index = 0;
@@ -49,12 +75,12 @@ static constexpr size_t CharCount(std::string_view str) noexcept {
   return count;
 }
 
-static std::string ToLower(std::string_view str) {
+namespace detail {
+
+// Reference byte-by-byte implementation, also used as the fallback when no SIMD kernel is available
+static void ToLowerScalar(std::string_view str, char* out) noexcept {
   // Define named constants for UTF-8 Cyrillic character handling
-  constexpr uint8_t CYRILLIC_A_CAPITAL_FIRST_BYTE = 0xD0;
-  constexpr uint8_t CYRILLIC_A_CAPITAL_SECOND_BYTE = 0x90;
   constexpr uint8_t CYRILLIC_A_SMALL_FIRST_BYTE = 0xD0;
-  constexpr uint8_t CYRILLIC_A_SMALL_SECOND_BYTE = 0xB0;
 
   constexpr uint8_t CYRILLIC_CAPITAL_FIRST_BYTE = 0xD0;
   constexpr uint8_t CYRILLIC_CAPITAL_A_TO_P_START = 0x90;  // А (A)
@@ -69,15 +95,12 @@ static std::string ToLower(std::string_view str) {
   constexpr uint8_t CYRILLIC_YO_SMALL_FIRST_BYTE = 0xD1;
   constexpr uint8_t CYRILLIC_YO_SMALL_SECOND_BYTE = 0x91;
 
-  std::string result;
-  result.reserve(str.size());
-
   for (size_t i = 0; i < str.size();) {
     const int char_len = CharLen(str, i);
 
     // Invalid UTF-8 or end of string
     if (char_len <= 0 || i + char_len > str.size()) {
-      result.push_back(str[i]);
+      *out++ = str[i];
       ++i;
       continue;
     }
@@ -88,7 +111,7 @@ static std::string ToLower(std::string_view str) {
       if (ch >= 'A' && ch <= 'Z') {
         ch = static_cast<char>(ch - 'A' + 'a');  // Convert to lowercase with explicit cast
       }
-      result.push_back(ch);
+      *out++ = ch;
       ++i;
       continue;
     }
@@ -101,8 +124,8 @@ static std::string ToLower(std::string_view str) {
       // Cyrillic uppercase letters А-П (A-P): D0 90-9F -> D0 B0-BF
       if (first == CYRILLIC_CAPITAL_FIRST_BYTE && second >= CYRILLIC_CAPITAL_A_TO_P_START &&
           second <= CYRILLIC_CAPITAL_A_TO_P_END) {
-        result.push_back(static_cast<char>(CYRILLIC_A_SMALL_FIRST_BYTE));
-        result.push_back(static_cast<char>(second + 0x20));  // Convert to lowercase
+        *out++ = static_cast<char>(CYRILLIC_A_SMALL_FIRST_BYTE);
+        *out++ = static_cast<char>(second + 0x20);  // Convert to lowercase
         i += 2;
         continue;
       }
@@ -110,16 +133,16 @@ static std::string ToLower(std::string_view str) {
       // Cyrillic uppercase letters Р-Я (R-YA): D0 A0-AF -> D1 80-8F
       if (first == CYRILLIC_CAPITAL_R_TO_YA_FIRST_BYTE && second >= CYRILLIC_CAPITAL_R_TO_YA_START &&
           second <= CYRILLIC_CAPITAL_R_TO_YA_END) {
-        result.push_back(static_cast<char>(CYRILLIC_YO_SMALL_FIRST_BYTE));           // First byte changes to D1
-        result.push_back(static_cast<char>(second - 0x20));  // Convert to lowercase
+        *out++ = static_cast<char>(CYRILLIC_YO_SMALL_FIRST_BYTE);  // First byte changes to D1
+        *out++ = static_cast<char>(second - 0x20);                 // Convert to lowercase
         i += 2;
         continue;
       }
 
       // Special case: Ё -> ё
       if (first == CYRILLIC_YO_CAPITAL_FIRST_BYTE && second == CYRILLIC_YO_CAPITAL_SECOND_BYTE) {
-        result.push_back(static_cast<char>(CYRILLIC_YO_SMALL_FIRST_BYTE));
-        result.push_back(static_cast<char>(CYRILLIC_YO_SMALL_SECOND_BYTE));
+        *out++ = static_cast<char>(CYRILLIC_YO_SMALL_FIRST_BYTE);
+        *out++ = static_cast<char>(CYRILLIC_YO_SMALL_SECOND_BYTE);
         i += 2;
         continue;
       }
@@ -127,14 +150,236 @@ static std::string ToLower(std::string_view str) {
 
     // Any other character: copy as is
     for (int j = 0; j < char_len; ++j) {
-      result.push_back(str[i + j]);
+      *out++ = str[i + j];
     }
     i += char_len;
   }
+}
+
+// Lowercases a single byte of valid UTF-8 given its neighbours. Lowercasing never changes the length
+// of ASCII and two-byte Cyrillic characters, so every output byte depends only on these three bytes:
+// a 0xD0 lead byte is always followed by its continuation byte.
+static constexpr uint8_t LowerByte(uint8_t prev, uint8_t cur, uint8_t next) noexcept {
+  if (cur >= 'A' && cur <= 'Z') return cur + 0x20;
+  if (prev == 0xD0) {
+    if (cur >= 0x90 && cur <= 0x9F) return cur + 0x20;  // А-П: D0 90-9F -> D0 B0-BF
+    if (cur >= 0xA0 && cur <= 0xAF) return cur - 0x20;  // Р-Я: D0 A0-AF -> D1 80-8F
+    if (cur == 0x81) return 0x91;                        // Ё: D0 81 -> D1 91
+  }
+  if (cur == 0xD0 && ((next >= 0xA0 && next <= 0xAF) || next == 0x81)) return 0xD1;
+  return cur;
+}
+
+// Fast two-byte-only validity check of a single byte: a continuation byte must follow a two-byte lead
+// and nothing may start a longer sequence. Failing it only means the full validator has to decide.
+static constexpr bool IsValidTwoByteUtf8Byte(uint8_t prev, uint8_t cur) noexcept {
+  const bool is_continuation = (cur & 0xC0) == 0x80;
+  const bool prev_is_lead = prev >= 0xC2 && prev <= 0xDF;
+  return is_continuation == prev_is_lead && cur < 0xE0 && cur != 0xC0 && cur != 0xC1;
+}
+
+#if UTILS_CPU_DISPATCH
+// SSE2 is part of the x86-64 baseline and needs no target attribute
+namespace sse2 {
+
+struct Simd {
+  using Vector = __m128i;
+  static constexpr size_t kWidth = 16;
+
+  static Vector Load(const char* ptr) noexcept { return _mm_loadu_si128(reinterpret_cast<const Vector*>(ptr)); }
+  static void Store(char* ptr, Vector vec) noexcept { _mm_storeu_si128(reinterpret_cast<Vector*>(ptr), vec); }
+  static Vector Set(uint8_t value) noexcept { return _mm_set1_epi8(static_cast<char>(value)); }
+  static Vector Equal(Vector lhs, Vector rhs) noexcept { return _mm_cmpeq_epi8(lhs, rhs); }
+  static Vector Min(Vector lhs, Vector rhs) noexcept { return _mm_min_epu8(lhs, rhs); }
+  static Vector Add(Vector lhs, Vector rhs) noexcept { return _mm_add_epi8(lhs, rhs); }
+  static Vector Sub(Vector lhs, Vector rhs) noexcept { return _mm_sub_epi8(lhs, rhs); }
+  static Vector And(Vector lhs, Vector rhs) noexcept { return _mm_and_si128(lhs, rhs); }
+  static Vector Or(Vector lhs, Vector rhs) noexcept { return _mm_or_si128(lhs, rhs); }
+  static Vector AndNot(Vector mask, Vector value) noexcept { return _mm_andnot_si128(mask, value); }
+  static bool Any(Vector mask) noexcept { return _mm_movemask_epi8(mask) != 0; }
+};
+
+#define UTILS_UTF8_SIMD_TARGET
+#include "utf8_simd.inl"
+#undef UTILS_UTF8_SIMD_TARGET
+
+}  // namespace sse2
+
+namespace avx2 {
+
+struct Simd {
+  using Vector = __m256i;
+  static constexpr size_t kWidth = 32;
+
+  UTILS_TARGET_AVX2 static Vector Load(const char* ptr) noexcept {
+    return _mm256_loadu_si256(reinterpret_cast<const Vector*>(ptr));
+  }
+  UTILS_TARGET_AVX2 static void Store(char* ptr, Vector vec) noexcept {
+    _mm256_storeu_si256(reinterpret_cast<Vector*>(ptr), vec);
+  }
+  UTILS_TARGET_AVX2 static Vector Set(uint8_t value) noexcept { return _mm256_set1_epi8(static_cast<char>(value)); }
+  UTILS_TARGET_AVX2 static Vector Equal(Vector lhs, Vector rhs) noexcept { return _mm256_cmpeq_epi8(lhs, rhs); }
+  UTILS_TARGET_AVX2 static Vector Min(Vector lhs, Vector rhs) noexcept { return _mm256_min_epu8(lhs, rhs); }
+  UTILS_TARGET_AVX2 static Vector Add(Vector lhs, Vector rhs) noexcept { return _mm256_add_epi8(lhs, rhs); }
+  UTILS_TARGET_AVX2 static Vector Sub(Vector lhs, Vector rhs) noexcept { return _mm256_sub_epi8(lhs, rhs); }
+  UTILS_TARGET_AVX2 static Vector And(Vector lhs, Vector rhs) noexcept { return _mm256_and_si256(lhs, rhs); }
+  UTILS_TARGET_AVX2 static Vector Or(Vector lhs, Vector rhs) noexcept { return _mm256_or_si256(lhs, rhs); }
+  UTILS_TARGET_AVX2 static Vector AndNot(Vector mask, Vector value) noexcept {
+    return _mm256_andnot_si256(mask, value);
+  }
+  UTILS_TARGET_AVX2 static bool Any(Vector mask) noexcept { return _mm256_movemask_epi8(mask) != 0; }
+};
+
+#define UTILS_UTF8_SIMD_TARGET UTILS_TARGET_AVX2
+#include "utf8_simd.inl"
+#undef UTILS_UTF8_SIMD_TARGET
+
+}  // namespace avx2
+#endif
+
+// Full UTF-8 validation: rejects truncated sequences, overlong encodings, surrogates and code points
+// above U+10FFFF
+static constexpr bool IsValidScalar(std::string_view str) noexcept {
+  size_t index = 0;
+  while (index < str.size()) {
+    const auto lead = static_cast<uint8_t>(str[index]);
+    if (lead < 0x80) {
+      ++index;
+      continue;
+    }
+
+    size_t len = 0;
+    uint8_t second_min = 0x80;
+    uint8_t second_max = 0xBF;
+    if (lead >= 0xC2 && lead <= 0xDF) {
+      len = 2;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+      len = 3;
+      if (lead == 0xE0) second_min = 0xA0;  // Overlong
+      if (lead == 0xED) second_max = 0x9F;  // Surrogates
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+      len = 4;
+      if (lead == 0xF0) second_min = 0x90;  // Overlong
+      if (lead == 0xF4) second_max = 0x8F;  // Above U+10FFFF
+    } else {
+      return false;
+    }
+
+    if (index + len > str.size()) return false;
+
+    const auto second = static_cast<uint8_t>(str[index + 1]);
+    if (second < second_min || second > second_max) return false;
+    for (size_t i = 2; i < len; ++i) {
+      if (!IsContinuationByte(str[index + i])) return false;
+    }
+
+    index += len;
+  }
+
+  return true;
+}
+
+}  // namespace detail
+
+// Lowercases ASCII and Cyrillic letters (including Ё) of str into out, which must hold at least str.size()
+// bytes and may point to str itself. The output always has the same length as the input.
+static void ToLower(std::string_view str, char* out) noexcept {
+#if UTILS_CPU_DISPATCH
+  // Words are far shorter than a 64-byte AVX-512 block, so AVX2 serves AVX-512 hosts too
+  if (cpu::IsSupported(cpu::Isa::kAvx2)) {
+    detail::avx2::ToLowerSimd<false>(str.data(), str.size(), out);
+  } else {
+    detail::sse2::ToLowerSimd<false>(str.data(), str.size(), out);
+  }
+#else
+  detail::ToLowerScalar(str, out);
+#endif
+}
 
+static void ToLowerInPlace(std::span<char> str) noexcept { ToLower({str.data(), str.size()}, str.data()); }
+
+static std::string ToLower(std::string_view str) {
+  std::string result(str.size(), '\0');
+  ToLower(str, result.data());
   return result;
 }
 
+static bool IsValid(std::string_view str) noexcept {
+#if UTILS_CPU_DISPATCH
+  // The fast path only accepts ASCII and two-byte sequences; longer ones are checked separately
+  const bool is_two_byte_utf8 = cpu::IsSupported(cpu::Isa::kAvx2)
+                                    ? detail::avx2::IsTwoByteUtf8Simd(str.data(), str.size())
+                                    : detail::sse2::IsTwoByteUtf8Simd(str.data(), str.size());
+  return is_two_byte_utf8 || detail::IsValidScalar(str);
+#else
+  return detail::IsValidScalar(str);
+#endif
+}
+
+// Fused validation and lowercasing: returns false if str is not valid UTF-8, in which case the contents
+// of out are unspecified
+static bool ToLowerValidated(std::string_view str, char* out) noexcept {
+#if UTILS_CPU_DISPATCH
+  const bool is_two_byte_utf8 = cpu::IsSupported(cpu::Isa::kAvx2)
+                                    ? detail::avx2::ToLowerSimd<true>(str.data(), str.size(), out)
+                                    : detail::sse2::ToLowerSimd<true>(str.data(), str.size(), out);
+  if (is_two_byte_utf8) return true;
+  // The fast path only accepts ASCII and two-byte sequences. Lowercasing keeps lead and continuation
+  // bytes in their classes and is already correct for longer sequences, so only validity is left to check
+  // and out is checked because it may alias the input.
+  return detail::IsValidScalar({out, str.size()});
+#else
+  if (!detail::IsValidScalar(str)) return false;
+  detail::ToLowerScalar(str, out);
+  return true;
+#endif
+}
+
+static bool ToLowerValidatedInPlace(std::span<char> str) noexcept {
+  return ToLowerValidated({str.data(), str.size()}, str.data());
+}
+
+// Upper bound on the byte length of a folded lookup key, used to size stack buffers
+static constexpr size_t kMaxFoldedWordSize = 256;
+
+// Canonical lookup form of a word: surrounding whitespace trimmed, lowercased and ё folded to е.
+// Writes at most str.size() bytes to out and returns the folded length.
+static size_t Fold(std::string_view str, char* out) noexcept {
+  constexpr std::string_view kWhitespace = " \t\r\n";
+  constexpr uint8_t CYRILLIC_YO_SMALL_FIRST_BYTE = 0xD1;
+  constexpr uint8_t CYRILLIC_YO_SMALL_SECOND_BYTE = 0x91;
+  constexpr uint8_t CYRILLIC_IE_SMALL_FIRST_BYTE = 0xD0;
+  constexpr uint8_t CYRILLIC_IE_SMALL_SECOND_BYTE = 0xB5;
+
+  const size_t begin = str.find_first_not_of(kWhitespace);
+  if (begin == std::string_view::npos) return 0;
+  str = str.substr(begin, str.find_last_not_of(kWhitespace) - begin + 1);
+
+  ToLower(str, out);
+
+  for (size_t i = 0; i + 1 < str.size(); ++i) {
+    if (static_cast<uint8_t>(out[i]) == CYRILLIC_YO_SMALL_FIRST_BYTE &&
+        static_cast<uint8_t>(out[i + 1]) == CYRILLIC_YO_SMALL_SECOND_BYTE) {
+      out[i] = static_cast<char>(CYRILLIC_IE_SMALL_FIRST_BYTE);
+      out[i + 1] = static_cast<char>(CYRILLIC_IE_SMALL_SECOND_BYTE);
+      ++i;
+    }
+  }
+
+  return str.size();
+}
+
+static bool FoldedEqual(std::string_view lhs, std::string_view rhs) noexcept {
+  if (lhs == rhs) return true;
+  if (lhs.size() > kMaxFoldedWordSize || rhs.size() > kMaxFoldedWordSize) return false;
+
+  std::array<char, kMaxFoldedWordSize> lhs_buffer;
+  std::array<char, kMaxFoldedWordSize> rhs_buffer;
+  const size_t lhs_size = Fold(lhs, lhs_buffer.data());
+  const size_t rhs_size = Fold(rhs, rhs_buffer.data());
+  return std::string_view(lhs_buffer.data(), lhs_size) == std::string_view(rhs_buffer.data(), rhs_size);
+}
+
 static size_t CommonPrefixLength(std::string_view lhs, std::string_view rhs) {
   size_t common_chars = 0;
   size_t lhs_idx = 0;
@@ -145,8 +390,9 @@ static size_t CommonPrefixLength(std::string_view lhs, std::string_view rhs) {
     const int lhs_len = CharLen(lhs, lhs_idx);
     const int rhs_len = CharLen(rhs, rhs_idx);
 
-    // Invalid UTF-8 or different character sizes
+    // Invalid or truncated UTF-8, or different character sizes
     if (lhs_len <= 0 || rhs_len <= 0 || lhs_len != rhs_len) break;
+    if (lhs_idx + lhs_len > lhs.size() || rhs_idx + rhs_len > rhs.size()) break;
 
     // Check if the characters match
     bool same = true;
@@ -168,4 +414,77 @@ static size_t CommonPrefixLength(std::string_view lhs, std::string_view rhs) {
   return common_chars;
 }
 
+// The first code points of a word, zero past its end, for comparing prefixes without decoding. Decoding stops at
+// invalid UTF-8, like CommonPrefixLength does.
+struct alignas(32) CodePointPrefix {
+  static constexpr size_t kSize = 8;
+
+  std::array<char32_t, kSize> code_points{};
+};
+
+static constexpr CodePointPrefix MakeCodePointPrefix(std::string_view str) noexcept {
+  CodePointPrefix prefix;
+  size_t index = 0;
+  for (size_t lane = 0; lane < CodePointPrefix::kSize && index < str.size(); ++lane) {
+    const int len = CharLen(str, index);
+    if (len < 0 || index + len > str.size()) break;
+    prefix.code_points[lane] = DecodeCodePoint(str, index);
+    index += len;
+  }
+  return prefix;
+}
+
+namespace detail {
+
+// Bit i is set if lane i holds the same code point in both prefixes and isn't past the end
+static constexpr uint32_t MatchingLanesScalar(const CodePointPrefix& lhs, const CodePointPrefix& rhs) noexcept {
+  uint32_t mask = 0;
+  for (size_t lane = 0; lane < CodePointPrefix::kSize; ++lane) {
+    const bool matches = lhs.code_points[lane] == rhs.code_points[lane] && lhs.code_points[lane] != 0;
+    mask |= static_cast<uint32_t>(matches) << lane;
+  }
+  return mask;
+}
+
+#if UTILS_CPU_DISPATCH
+static inline uint32_t MatchingLanesSse2(const CodePointPrefix& lhs, const CodePointPrefix& rhs) noexcept {
+  const auto* lhs_lanes = reinterpret_cast<const __m128i*>(lhs.code_points.data());
+  const auto* rhs_lanes = reinterpret_cast<const __m128i*>(rhs.code_points.data());
+  const __m128i zero = _mm_setzero_si128();
+
+  uint32_t mask = 0;
+  for (int half = 0; half < 2; ++half) {
+    const __m128i left = _mm_load_si128(lhs_lanes + half);
+    const __m128i matches = _mm_andnot_si128(_mm_cmpeq_epi32(left, zero),
+                                             _mm_cmpeq_epi32(left, _mm_load_si128(rhs_lanes + half)));
+    mask |= static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(matches))) << (half * 4);
+  }
+  return mask;
+}
+
+UTILS_TARGET_AVX2 static inline uint32_t MatchingLanesAvx2(const CodePointPrefix& lhs,
+                                                           const CodePointPrefix& rhs) noexcept {
+  // All eight lanes in one compare
+  const __m256i left = _mm256_load_si256(reinterpret_cast<const __m256i*>(lhs.code_points.data()));
+  const __m256i right = _mm256_load_si256(reinterpret_cast<const __m256i*>(rhs.code_points.data()));
+  const __m256i matches =
+      _mm256_andnot_si256(_mm256_cmpeq_epi32(left, _mm256_setzero_si256()), _mm256_cmpeq_epi32(left, right));
+  return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(matches)));
+}
+#endif
+
+}  // namespace detail
+
+// Same as CommonPrefixLength of the words, but only exact up to CodePointPrefix::kSize code points
+static inline size_t CommonPrefixLength(const CodePointPrefix& lhs, const CodePointPrefix& rhs) noexcept {
+#if UTILS_CPU_DISPATCH
+  const uint32_t mask = cpu::IsSupported(cpu::Isa::kAvx2) ? detail::MatchingLanesAvx2(lhs, rhs)
+                                                          : detail::MatchingLanesSse2(lhs, rhs);
+#else
+  const uint32_t mask = detail::MatchingLanesScalar(lhs, rhs);
+#endif
+  // The first mismatching lane ends the prefix, bits above the last lane are clear
+  return static_cast<size_t>(std::countr_one(mask));
+}
+
 }  // namespace utils::utf8
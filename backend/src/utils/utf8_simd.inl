@@ -0,0 +1,104 @@
+// Generic UTF-8 kernels, included once per instruction set by utf8.hpp. The including namespace provides
+// the Simd vector traits and defines UTILS_UTF8_SIMD_TARGET as the target attribute of that instruction set.
+
+UTILS_UTF8_SIMD_TARGET static Simd::Vector InRange(Simd::Vector vec, uint8_t low, uint8_t high) noexcept {
+  // Unsigned range check: (vec - low) <= (high - low)
+  const auto shifted = Simd::Sub(vec, Simd::Set(low));
+  return Simd::Equal(Simd::Min(shifted, Simd::Set(high - low)), shifted);
+}
+
+// Vector form of IsValidTwoByteUtf8Byte: a non-zero lane marks a byte failing the fast check
+UTILS_UTF8_SIMD_TARGET static Simd::Vector InvalidTwoByteMask(Simd::Vector cur, Simd::Vector before) noexcept {
+  const auto is_continuation = Simd::Equal(Simd::And(cur, Simd::Set(0xC0)), Simd::Set(0x80));
+  const auto prev_is_lead = InRange(before, 0xC2, 0xDF);
+  const auto mismatch = Simd::AndNot(Simd::Equal(is_continuation, prev_is_lead), Simd::Set(0xFF));
+  const auto not_two_byte = Simd::Or(InRange(cur, 0xE0, 0xFF), InRange(cur, 0xC0, 0xC1));
+  return Simd::Or(mismatch, not_two_byte);
+}
+
+UTILS_UTF8_SIMD_TARGET static Simd::Vector LowerBlock(Simd::Vector before, Simd::Vector cur,
+                                                      Simd::Vector after) noexcept {
+  const auto prev_is_d0 = Simd::Equal(before, Simd::Set(0xD0));
+  const auto cur_is_d0 = Simd::Equal(cur, Simd::Set(0xD0));
+
+  const auto add_0x20 = Simd::Or(InRange(cur, 'A', 'Z'), Simd::And(prev_is_d0, InRange(cur, 0x90, 0x9F)));
+  const auto sub_0x20 = Simd::And(prev_is_d0, InRange(cur, 0xA0, 0xAF));
+  const auto add_0x10 = Simd::And(prev_is_d0, Simd::Equal(cur, Simd::Set(0x81)));
+  const auto add_0x01 =
+      Simd::And(cur_is_d0, Simd::Or(InRange(after, 0xA0, 0xAF), Simd::Equal(after, Simd::Set(0x81))));
+
+  auto delta = Simd::And(add_0x20, Simd::Set(0x20));
+  delta = Simd::Or(delta, Simd::And(sub_0x20, Simd::Set(0xE0)));
+  delta = Simd::Or(delta, Simd::And(add_0x10, Simd::Set(0x10)));
+  delta = Simd::Or(delta, Simd::And(add_0x01, Simd::Set(0x01)));
+  return Simd::Add(cur, delta);
+}
+
+// Copies the bytes [index - 1, size) into a zero-padded block, so that the remainder of the string is
+// processed by one more vector block and the padding stands in for the bytes past the end
+UTILS_UTF8_SIMD_TARGET static std::array<char, Simd::kWidth + 2> PaddedTail(const char* str, size_t size,
+                                                                             size_t index) noexcept {
+  std::array<char, Simd::kWidth + 2> tail{};
+  std::copy_n(str + index - 1, size - index + 1, tail.data());
+  return tail;
+}
+
+UTILS_UTF8_SIMD_TARGET static bool IsTwoByteUtf8Simd(const char* str, size_t size) noexcept {
+  if (size == 0) return true;
+
+  // A block at index needs bytes [index - 1, index + kWidth)
+  Simd::Vector invalid = Simd::Set(0);
+  size_t index = 1;
+  for (; index + Simd::kWidth <= size; index += Simd::kWidth) {
+    invalid = Simd::Or(invalid, InvalidTwoByteMask(Simd::Load(str + index), Simd::Load(str + index - 1)));
+  }
+
+  const auto tail = PaddedTail(str, size, index);
+  invalid = Simd::Or(invalid, InvalidTwoByteMask(Simd::Load(tail.data() + 1), Simd::Load(tail.data())));
+
+  return IsValidTwoByteUtf8Byte(0, static_cast<uint8_t>(str[0])) && !Simd::Any(invalid);
+}
+
+// Lowercases str into out (which may alias str) and optionally runs the two-byte validity check.
+// Every vector block reads its left and right neighbours, so results are stored one block late
+// to keep in-place conversion reading original bytes only.
+template <bool kValidate>
+UTILS_UTF8_SIMD_TARGET static bool ToLowerSimd(const char* str, size_t size, char* out) noexcept {
+  if (size == 0) return true;
+
+  const auto first = static_cast<uint8_t>(str[0]);
+  const bool head_valid = !kValidate || IsValidTwoByteUtf8Byte(0, first);
+  const auto head = static_cast<char>(LowerByte(0, first, size > 1 ? static_cast<uint8_t>(str[1]) : 0));
+
+  Simd::Vector invalid = Simd::Set(0);
+  Simd::Vector pending{};
+  bool has_pending = false;
+  size_t pending_index = 0;
+
+  // A block at index needs bytes [index - 1, index + kWidth]
+  size_t index = 1;
+  for (; index + Simd::kWidth < size; index += Simd::kWidth) {
+    const auto before = Simd::Load(str + index - 1);
+    const auto cur = Simd::Load(str + index);
+    const auto lowered = LowerBlock(before, cur, Simd::Load(str + index + 1));
+    if constexpr (kValidate) invalid = Simd::Or(invalid, InvalidTwoByteMask(cur, before));
+
+    if (has_pending) Simd::Store(out + pending_index, pending);
+    pending = lowered;
+    pending_index = index;
+    has_pending = true;
+  }
+
+  // The tail is copied out before the last vector block is written
+  auto tail = PaddedTail(str, size, index);
+  const auto before = Simd::Load(tail.data());
+  const auto cur = Simd::Load(tail.data() + 1);
+  Simd::Store(tail.data() + 1, LowerBlock(before, cur, Simd::Load(tail.data() + 2)));
+  if constexpr (kValidate) invalid = Simd::Or(invalid, InvalidTwoByteMask(cur, before));
+
+  out[0] = head;
+  if (has_pending) Simd::Store(out + pending_index, pending);
+  std::copy_n(tail.data() + 1, size - index, out + index);
+
+  return head_valid && !Simd::Any(invalid);
+}
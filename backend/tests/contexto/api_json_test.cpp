@@ -0,0 +1,141 @@
+#include <userver/utest/utest.hpp>
+#include <contexto/api_json.hpp>
+#include <utils/request_arena.hpp>
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+// Allocations made by the current thread while counting is enabled
+thread_local bool is_counting_allocations = false;
+thread_local size_t allocation_count = 0;
+
+class AllocationCounter final {
+public:
+  AllocationCounter() {
+    allocation_count = 0;
+    is_counting_allocations = true;
+  }
+
+  ~AllocationCounter() { is_counting_allocations = false; }
+
+  size_t Count() const noexcept { return allocation_count; }
+};
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+  if (is_counting_allocations) ++allocation_count;
+  if (void* ptr = std::malloc(size == 0 ? 1 : size)) return ptr;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+namespace {
+
+using namespace contexto::api;
+
+// Whole request/response cycle of a guess, as done by the guess handler
+size_t CountGuessAllocations(std::string_view body) {
+  const AllocationCounter counter;
+  const std::string word = ParseStringField(body, "word");
+  const std::string response = MakeGuessResponse(word, 42);
+  return counter.Count();
+}
+
+// Same with the parsed word in the request arena, as the guess handler does
+size_t CountArenaGuessAllocations(std::string_view body) {
+  utils::RequestArena arena;
+  const AllocationCounter counter;
+  const std::pmr::string word = ParseStringField(body, "word", arena);
+  const std::string response = MakeGuessResponse(word, 42);
+  return counter.Count();
+}
+
+UTEST(ApiJson, ParseStringField) {
+  EXPECT_EQ(ParseStringField(R"({"word": "кошка"})", "word"), "кошка");
+  EXPECT_EQ(ParseStringField(R"({"other": 1, "word": "кот"})", "word"), "кот");
+  EXPECT_EQ(ParseStringField(R"({"session_id": "abc"})", "session_id"), "abc");
+
+  // Nested fields with the same name are not the top-level field
+  EXPECT_EQ(ParseStringField(R"({"meta": {"word": "нет"}, "list": [{"word": "нет"}, 1, null], "word": "да"})",
+                             "word"),
+            "да");
+
+  EXPECT_EQ(ParseStringField(R"({})", "word"), "");
+  EXPECT_EQ(ParseStringField(R"({"meta": {"word": "нет"}})", "word"), "");
+  EXPECT_EQ(ParseStringField(R"({"word": "\"кот\"\n"})", "word"), "\"кот\"\n");
+}
+
+UTEST(ApiJson, ParseStringFieldErrors) {
+  EXPECT_ANY_THROW(ParseStringField("", "word"));
+  EXPECT_ANY_THROW(ParseStringField("{", "word"));
+  EXPECT_ANY_THROW(ParseStringField(R"({"word": "кот")", "word"));
+  EXPECT_ANY_THROW(ParseStringField(R"(["word"])", "word"));
+  EXPECT_ANY_THROW(ParseStringField(R"("word")", "word"));
+  EXPECT_ANY_THROW(ParseStringField(R"({"word": 1})", "word"));
+  EXPECT_ANY_THROW(ParseStringField(R"({"word": null})", "word"));
+  EXPECT_ANY_THROW(ParseStringField(R"({"word": ["кот"]})", "word"));
+  EXPECT_ANY_THROW(ParseStringField(R"({"word": {"text": "кот"}})", "word"));
+}
+
+UTEST(ApiJson, ParseStringFields) {
+  static constexpr std::array<std::string_view, 2> kFields = {"mode", "difficulty"};
+  std::pmr::monotonic_buffer_resource resource;
+
+  std::array values = {std::pmr::string(&resource), std::pmr::string(&resource)};
+  ParseStringFields(R"({"difficulty": "hard", "meta": {"mode": "нет"}, "mode": "daily"})", kFields, values);
+  EXPECT_EQ(values[0], "daily");
+  EXPECT_EQ(values[1], "hard");
+
+  values = {std::pmr::string(&resource), std::pmr::string(&resource)};
+  ParseStringFields(R"({"difficulty": "easy"})", kFields, values);
+  EXPECT_EQ(values[0], "");
+  EXPECT_EQ(values[1], "easy");
+
+  EXPECT_ANY_THROW(ParseStringFields(R"({"mode": "daily", "difficulty": 1})", kFields, values));
+}
+
+UTEST(ApiJson, Responses) {
+  EXPECT_EQ(MakeError("Invalid word"), R"({"error":"Invalid word"})");
+  EXPECT_EQ(MakeError("say \"hi\""), R"({"error":"say \"hi\""})");
+
+  const std::array<std::string_view, 2> suggestions = {"кот", "кит"};
+  EXPECT_EQ(MakeUnknownWordError(suggestions), R"({"error":"Invalid word","suggestions":["кот","кит"]})");
+  EXPECT_EQ(MakeUnknownWordError({}), R"({"error":"Invalid word"})");
+
+  EXPECT_EQ(MakeNewGameResponse("id"), R"({"success":true,"session_id":"id"})");
+  EXPECT_EQ(MakeNewGameResponse("id", "2026-10-18"),
+            R"({"success":true,"session_id":"id","puzzle_date":"2026-10-18"})");
+  EXPECT_EQ(MakeNewGameResponse("id", {}, "hard"), R"({"success":true,"session_id":"id","difficulty":"hard"})");
+  EXPECT_EQ(MakeGuessResponse("кот", 1), R"({"word":"кот","rank":1,"correct":"yes"})");
+  EXPECT_EQ(MakeGuessResponse("кот", 7, "кто"), R"({"word":"кот","rank":7,"correct":"no","corrected_from":"кто"})");
+  EXPECT_EQ(MakeGuessResponse("кот", 7, {}, true), R"({"word":"кот","rank":7,"correct":"no","duplicate":true})");
+  EXPECT_EQ(MakeGiveUpResponse("кот"), R"({"success":true,"target_word":"кот"})");
+}
+
+UTEST(ApiJson, GuessAllocations) {
+  // Warm up anything allocated once per thread
+  CountGuessAllocations(R"({"word": "кошка"})");
+
+  const size_t allocations = CountGuessAllocations(R"({"word": "кошка"})");
+  EXPECT_LE(allocations, 8);
+
+  // Skipped fields don't cost allocations
+  EXPECT_EQ(CountGuessAllocations(R"({"client": {"version": "1.2", "tags": ["a", "b"]}, "ts": 1, "word": "кошка"})"),
+            allocations);
+}
+
+UTEST(ApiJson, ArenaGuessAllocations) {
+  // Long enough not to fit into a string object, the arena slab comes from the thread's cache after the warm-up
+  constexpr std::string_view kBody = R"({"word": "достопримечательность"})";
+  CountGuessAllocations(kBody);
+  CountArenaGuessAllocations(kBody);
+
+  EXPECT_LT(CountArenaGuessAllocations(kBody), CountGuessAllocations(kBody));
+}
+
+}  // namespace
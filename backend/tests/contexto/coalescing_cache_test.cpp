@@ -0,0 +1,74 @@
+#include <userver/utest/utest.hpp>
+#include <userver/engine/single_consumer_event.hpp>
+#include <userver/engine/sleep.hpp>
+#include <userver/utils/async.hpp>
+#include <contexto/coalescing_cache.hpp>
+
+namespace {
+
+using contexto::CoalescingCache;
+
+UTEST(CoalescingCache, CachesBuiltValues) {
+  CoalescingCache<int, int> cache(4);
+  int builds = 0;
+  const auto start_build = [&] {
+    return userver::utils::SharedAsync("build", [&] { return ++builds * 10; });
+  };
+
+  EXPECT_EQ(cache.Get(1, start_build), 10);
+  EXPECT_EQ(cache.Get(1, start_build), 10);
+  EXPECT_EQ(builds, 1);
+  EXPECT_EQ(cache.Hits(), 1);
+  EXPECT_EQ(cache.Size(), 1);
+  EXPECT_EQ(cache.InFlightSize(), 0);
+}
+
+UTEST(CoalescingCache, RetriesFailedBuild) {
+  CoalescingCache<int, int> cache(4);
+  int attempts = 0;
+  const auto start_build = [&] {
+    return userver::utils::SharedAsync("build", [&] {
+      if (++attempts == 1) throw std::runtime_error("build failed");
+      return 42;
+    });
+  };
+
+  EXPECT_THROW(cache.Get(1, start_build), std::runtime_error);
+  EXPECT_EQ(cache.InFlightSize(), 0);
+  EXPECT_EQ(cache.Failures(), 1);
+
+  // The failed build isn't joined again, the retry starts a new one
+  EXPECT_EQ(cache.Get(1, start_build), 42);
+  EXPECT_EQ(attempts, 2);
+  EXPECT_EQ(cache.Builds(), 2);
+  EXPECT_EQ(cache.Get(1, start_build), 42);
+  EXPECT_EQ(attempts, 2);
+}
+
+UTEST(CoalescingCache, CancelledWaiterKeepsTheBuild) {
+  CoalescingCache<int, int> cache(4);
+  userver::engine::SingleConsumerEvent release;
+  int builds = 0;
+  const auto start_build = [&] {
+    return userver::utils::SharedAsync("build", [&] {
+      ++builds;
+      [[maybe_unused]] const bool released = release.WaitForEvent();
+      return 42;
+    });
+  };
+
+  auto waiter = userver::utils::Async("waiter", [&] { return cache.Get(1, start_build); });
+  while (cache.InFlightSize() == 0) userver::engine::Yield();
+  waiter.SyncCancel();
+
+  // The build still runs for other waiters, so it is neither a failure nor forgotten
+  EXPECT_EQ(cache.Failures(), 0);
+  EXPECT_EQ(cache.InFlightSize(), 1);
+
+  release.Send();
+  EXPECT_EQ(cache.Get(1, start_build), 42);
+  EXPECT_EQ(builds, 1);
+  EXPECT_EQ(cache.Coalesced(), 1);
+}
+
+}  // namespace
@@ -0,0 +1,84 @@
+#include <userver/utest/utest.hpp>
+#include <contexto/word-embedding/embedding_projection.hpp>
+
+namespace {
+
+using namespace contexto;
+
+// Unit embeddings spanning only the first `rank` axes of a `dimension`-dimensional space, rotated so
+// that the subspace isn't axis-aligned
+models::EmbeddingMatrix MakeLowRankEmbeddings(size_t count, size_t dimension, size_t rank, std::mt19937& rng) {
+  std::normal_distribution<float> dist(0.0f, 1.0f);
+  const Eigen::MatrixXf rotation =
+      Eigen::MatrixXf::NullaryExpr(dimension, dimension, [&] { return dist(rng); }).householderQr().householderQ();
+
+  models::EmbeddingMatrix embeddings(count, dimension);
+  for (size_t i = 0; i < count; ++i) {
+    Eigen::VectorXf embedding = Eigen::VectorXf::Zero(dimension);
+    for (size_t axis = 0; axis < rank; ++axis) {
+      embedding[axis] = dist(rng);
+    }
+    embeddings.row(i) = (rotation * embedding).normalized().transpose();
+  }
+  return embeddings;
+}
+
+UTEST(EmbeddingProjection, SpearmanCorrelation) {
+  const std::vector<float> values = {0.1f, 0.5f, 0.3f, 0.9f, -0.2f};
+  const std::vector<float> scaled = {1.0f, 25.0f, 9.0f, 81.0f, -4.0f};
+  const std::vector<float> reversed = {0.9f, 0.5f, 0.7f, 0.1f, 1.2f};
+
+  EXPECT_DOUBLE_EQ(SpearmanCorrelation(values, values), 1.0);
+  EXPECT_DOUBLE_EQ(SpearmanCorrelation(values, scaled), 1.0);
+  EXPECT_DOUBLE_EQ(SpearmanCorrelation(values, reversed), -1.0);
+}
+
+UTEST(EmbeddingProjection, PcaRecoversLowRankSubspace) {
+  std::mt19937 rng(7);
+  const auto embeddings = MakeLowRankEmbeddings(500, 32, 4, rng);
+
+  const auto projection = EmbeddingProjection::FitPca(embeddings, 8, 500, rng);
+  EXPECT_EQ(projection.InputDimension(), 32);
+  EXPECT_EQ(projection.MaxDimension(), 8);
+  EXPECT_NEAR(projection.ExplainedVariance(4), 1.0, 1e-4);
+  EXPECT_LT(projection.ExplainedVariance(2), 0.9);
+
+  const auto projected = projection.Apply(embeddings.row(0).transpose(), 4);
+  EXPECT_EQ(projected.size(), 4);
+  EXPECT_NEAR(projected.norm(), 1.0f, 1e-5f);
+
+  // Projecting all rows at once matches projecting them one by one
+  const auto projected_rows = projection.ApplyToRows(embeddings, 4);
+  ASSERT_EQ(projected_rows.rows(), 500);
+  ASSERT_EQ(projected_rows.cols(), 4);
+  EXPECT_TRUE(projected_rows.row(0).transpose().isApprox(projected, 1e-5f));
+
+  // Four components keep every dot product, so neighbour order is unchanged
+  const std::vector<size_t> dimensions = {2, 4};
+  const auto quality = EvaluateProjection(embeddings, projection, dimensions, {.queries = 20, .top_k = 10}, rng);
+  ASSERT_EQ(quality.size(), 2);
+  EXPECT_EQ(quality[1].dimension, 4);
+  EXPECT_NEAR(quality[1].spearman, 1.0, 1e-3);
+  EXPECT_NEAR(quality[1].top_k_overlap, 1.0, 1e-9);
+  EXPECT_LT(quality[0].spearman, quality[1].spearman);
+}
+
+UTEST(EmbeddingProjection, RandomProjectionImprovesWithDimension) {
+  std::mt19937 rng(11);
+  const auto embeddings = MakeLowRankEmbeddings(400, 128, 16, rng);
+
+  const auto projection = EmbeddingProjection::MakeRandom(128, 96, rng);
+  EXPECT_EQ(projection.MaxDimension(), 96);
+  EXPECT_EQ(projection.ExplainedVariance(96), 0.0);
+
+  const std::vector<size_t> dimensions = {8, 96, 200};
+  const auto quality = EvaluateProjection(embeddings, projection, dimensions, {.queries = 20, .top_k = 20}, rng);
+
+  // Dimensions above MaxDimension() are skipped
+  ASSERT_EQ(quality.size(), 2);
+  EXPECT_GT(quality[1].spearman, quality[0].spearman);
+  EXPECT_GT(quality[1].top_k_overlap, quality[0].top_k_overlap);
+  EXPECT_GT(quality[1].spearman, 0.8);
+}
+
+}  // namespace
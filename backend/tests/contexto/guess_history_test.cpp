@@ -0,0 +1,57 @@
+#include <userver/utest/utest.hpp>
+#include <contexto/guess_history.hpp>
+
+namespace {
+
+using contexto::GuessedWord;
+using contexto::GuessHistory;
+
+std::vector<int> Ranks(std::span<const contexto::RankedGuess> guesses) {
+  std::vector<int> ranks;
+  for (const auto& guess : guesses) {
+    ranks.push_back(guess.rank);
+  }
+  return ranks;
+}
+
+UTEST(GuessHistory, KeepsGuessesInRankOrder) {
+  GuessHistory history;
+  EXPECT_EQ(history.Best(), nullptr);
+
+  EXPECT_TRUE(history.Add({.index = 10}, 500));
+  EXPECT_TRUE(history.Add({.index = 3}, 40));
+  EXPECT_TRUE(history.Add({.index = 7}, 1200));
+  EXPECT_TRUE(history.Add({.index = 5}, 40));
+
+  ASSERT_NE(history.Best(), nullptr);
+  EXPECT_EQ(history.Best()->rank, 40);
+  EXPECT_EQ(history.Best()->word.index, 3);
+  EXPECT_EQ(Ranks(history.Slice(0, 10)), (std::vector<int>{40, 40, 500, 1200}));
+}
+
+UTEST(GuessHistory, RejectsRepeatedWords) {
+  GuessHistory history;
+  EXPECT_TRUE(history.Add({.index = 4, .has_pos = true}, 12));
+  EXPECT_FALSE(history.Add({.index = 4, .has_pos = true}, 12));
+  EXPECT_EQ(history.Size(), 1);
+
+  // A bare guess of the same word is ranked by its best variant, so it's a different guess
+  EXPECT_TRUE(history.Add({.index = 4, .has_pos = false}, 9));
+  EXPECT_EQ(history.FindRank({.index = 4, .has_pos = true}), 12);
+  EXPECT_EQ(history.FindRank({.index = 4, .has_pos = false}), 9);
+  EXPECT_EQ(history.FindRank(GuessedWord{.index = 5}), std::nullopt);
+}
+
+UTEST(GuessHistory, SlicesPages) {
+  GuessHistory history;
+  for (uint32_t i = 0; i < 10; ++i) {
+    history.Add({.index = i}, static_cast<int>(100 - i));
+  }
+
+  EXPECT_EQ(Ranks(history.Slice(0, 3)), (std::vector<int>{91, 92, 93}));
+  EXPECT_EQ(Ranks(history.Slice(8, 3)), (std::vector<int>{99, 100}));
+  EXPECT_TRUE(history.Slice(10, 3).empty());
+  EXPECT_TRUE(history.Slice(25, 3).empty());
+}
+
+}  // namespace
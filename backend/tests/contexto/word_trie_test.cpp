@@ -0,0 +1,114 @@
+#include <userver/utest/utest.hpp>
+#include <contexto/word-embedding/word_trie.hpp>
+
+namespace {
+
+using contexto::WordTrie;
+
+WordTrie MakeTrie(std::initializer_list<std::string_view> words) {
+  std::vector<std::pair<std::string_view, uint32_t>> entries;
+  uint32_t id = 0;
+  for (const auto word : words) {
+    entries.emplace_back(word, id++);
+  }
+
+  WordTrie trie;
+  trie.Build(std::move(entries));
+  return trie;
+}
+
+std::vector<uint32_t> Ids(std::span<const WordTrie::Match> matches) {
+  std::vector<uint32_t> ids;
+  for (const auto& match : matches) {
+    ids.push_back(match.word_id);
+  }
+  return ids;
+}
+
+UTEST(WordTrie, ExactMatch) {
+  const auto trie = MakeTrie({"дом", "домик", "кот", "кит"});
+
+  const auto matches = trie.FindWithinDistance("домик", 0, 10);
+  ASSERT_EQ(matches.size(), 1);
+  EXPECT_EQ(matches[0].word_id, 1);
+  EXPECT_EQ(matches[0].distance, 0);
+
+  EXPECT_TRUE(trie.FindWithinDistance("дома", 0, 10).empty());
+}
+
+UTEST(WordTrie, Distances) {
+  const auto trie = MakeTrie({"дом", "домик", "кот", "кит", "ком"});
+
+  // Substitutions, insertions and deletions are counted in code points, not bytes
+  EXPECT_EQ(Ids(trie.FindWithinDistance("кат", 1, 10)), (std::vector<uint32_t>{2, 3}));
+  EXPECT_EQ(Ids(trie.FindWithinDistance("дм", 1, 10)), (std::vector<uint32_t>{0}));
+  EXPECT_EQ(Ids(trie.FindWithinDistance("домиик", 1, 10)), (std::vector<uint32_t>{1}));
+
+  // Closer matches come first
+  const auto matches = trie.FindWithinDistance("кот", 2, 10);
+  ASSERT_EQ(matches.size(), 4);
+  EXPECT_EQ(matches[0].word_id, 2);
+  EXPECT_EQ(matches[0].distance, 0);
+  EXPECT_EQ(matches[1].distance, 1);
+}
+
+UTEST(WordTrie, Limit) {
+  const auto trie = MakeTrie({"кот", "кит", "ком", "кол", "код"});
+
+  const auto matches = trie.FindWithinDistance("кот", 1, 2);
+  EXPECT_EQ(Ids(matches), (std::vector<uint32_t>{0, 1}));
+}
+
+UTEST(WordTrie, PrefixKeys) {
+  const auto trie = MakeTrie({"а", "аб", "абв", "б"});
+  EXPECT_EQ(trie.NodeCount(), 5);
+  EXPECT_EQ(Ids(trie.FindWithinDistance("аб", 0, 10)), (std::vector<uint32_t>{1}));
+  EXPECT_EQ(Ids(trie.FindWithinDistance("аб", 1, 10)), (std::vector<uint32_t>{1, 0, 2, 3}));
+}
+
+std::vector<uint32_t> Completions(const WordTrie& trie, std::string_view prefix, size_t limit) {
+  std::array<uint32_t, WordTrie::kMaxCompletions> ids{};
+  const size_t count = trie.FindWithPrefix(prefix, std::span(ids).first(std::min(limit, ids.size())));
+  return {ids.begin(), ids.begin() + count};
+}
+
+UTEST(WordTrie, PrefixSearch) {
+  // Ids are priorities: lower ids come first regardless of key order
+  const auto trie = MakeTrie({"кот", "дом", "корова", "ком", "домик", "кол", "к"});
+
+  EXPECT_EQ(Completions(trie, "ко", 10), (std::vector<uint32_t>{0, 2, 3, 5}));
+  EXPECT_EQ(Completions(trie, "к", 10), (std::vector<uint32_t>{0, 2, 3, 5, 6}));
+  EXPECT_EQ(Completions(trie, "дом", 10), (std::vector<uint32_t>{1, 4}));
+  EXPECT_EQ(Completions(trie, "домик", 10), (std::vector<uint32_t>{4}));
+  EXPECT_EQ(Completions(trie, "", 3), (std::vector<uint32_t>{0, 1, 2}));
+
+  EXPECT_TRUE(Completions(trie, "кит", 10).empty());
+  EXPECT_TRUE(Completions(trie, "домики", 10).empty());
+  EXPECT_TRUE(Completions(trie, "ко", 0).empty());
+}
+
+UTEST(WordTrie, PrefixSearchLimit) {
+  std::vector<std::string> words;
+  std::vector<std::pair<std::string_view, uint32_t>> entries;
+  for (size_t i = 0; i < 1000; ++i) {
+    words.push_back("слово" + std::to_string(i));
+  }
+  for (size_t i = 0; i < words.size(); ++i) {
+    // Reverse the priorities so they disagree with the key order
+    entries.emplace_back(words[i], static_cast<uint32_t>(words.size() - 1 - i));
+  }
+
+  WordTrie trie;
+  trie.Build(std::move(entries));
+
+  std::vector<uint32_t> expected(WordTrie::kMaxCompletions);
+  std::iota(expected.begin(), expected.end(), 0);
+  EXPECT_EQ(Completions(trie, "сло", WordTrie::kMaxCompletions), expected);
+
+  // "слово999" down to "слово995"
+  const auto nines = Completions(trie, "слово9", 5);
+  EXPECT_EQ(nines, (std::vector<uint32_t>{0, 1, 2, 3, 4}));
+  EXPECT_EQ(Completions(trie, "слово99", 20).size(), 11);
+}
+
+}  // namespace
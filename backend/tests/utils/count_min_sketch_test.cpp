@@ -0,0 +1,50 @@
+#include <userver/utest/utest.hpp>
+#include <utils/count_min_sketch.hpp>
+
+#include <thread>
+
+namespace {
+
+using utils::CountMinSketch;
+
+UTEST(CountMinSketch, NeverUndercounts) {
+  CountMinSketch sketch(64, 4);
+
+  // Far more keys than counters per row, so collisions are certain
+  for (uint64_t key = 0; key < 1000; ++key) {
+    sketch.Add(key, static_cast<uint32_t>(key % 7 + 1));
+  }
+
+  for (uint64_t key = 0; key < 1000; ++key) {
+    EXPECT_GE(sketch.Estimate(key), key % 7 + 1);
+  }
+}
+
+UTEST(CountMinSketch, IsExactWithoutCollisions) {
+  CountMinSketch sketch(1 << 16, 4);
+  sketch.Add(42, 5);
+  sketch.Add(42);
+  sketch.Add(7, 3);
+
+  EXPECT_EQ(sketch.Estimate(42), 6);
+  EXPECT_EQ(sketch.Estimate(7), 3);
+  EXPECT_EQ(sketch.Estimate(1), 0);
+}
+
+UTEST(CountMinSketch, CountsConcurrentAdds) {
+  constexpr uint32_t kAddsPerThread = 100'000;
+  CountMinSketch sketch(1024, 4);
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&] {
+      for (uint32_t j = 0; j < kAddsPerThread; ++j) sketch.Add(j % 2);
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  EXPECT_GE(sketch.Estimate(0), 2 * kAddsPerThread);
+  EXPECT_GE(sketch.Estimate(1), 2 * kAddsPerThread);
+}
+
+}  // namespace
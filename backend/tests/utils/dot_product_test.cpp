@@ -0,0 +1,60 @@
+#include <userver/utest/utest.hpp>
+#include <utils/dot_product.hpp>
+
+#include <random>
+#include <vector>
+
+namespace {
+
+using namespace utils::simd;
+
+std::vector<float> RandomVector(size_t size, std::mt19937& rng) {
+  std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+  std::vector<float> values(size);
+  for (auto& value : values) {
+    value = dist(rng);
+  }
+  return values;
+}
+
+double ReferenceDot(const std::vector<float>& lhs, const std::vector<float>& rhs) {
+  double sum = 0.0;
+  for (size_t i = 0; i < lhs.size(); ++i) {
+    sum += static_cast<double>(lhs[i]) * rhs[i];
+  }
+  return sum;
+}
+
+UTEST(DotProduct, KernelsMatchReference) {
+  std::mt19937 rng(42);
+
+  // Sizes around every vector width and unroll factor, plus the embedding dimension
+  for (const size_t size : {0, 1, 3, 4, 7, 8, 15, 16, 17, 31, 32, 33, 63, 64, 65, 100, 300}) {
+    const auto lhs = RandomVector(size, rng);
+    const auto rhs = RandomVector(size, rng);
+    const double expected = ReferenceDot(lhs, rhs);
+    const double tolerance = 1e-5 * static_cast<double>(size + 1);
+
+    EXPECT_NEAR(detail::DotScalar(lhs.data(), rhs.data(), size), expected, tolerance) << "size " << size;
+    EXPECT_NEAR(Dot(lhs.data(), rhs.data(), size), expected, tolerance) << "size " << size;
+
+#if UTILS_CPU_DISPATCH
+    EXPECT_NEAR(detail::DotSse2(lhs.data(), rhs.data(), size), expected, tolerance) << "size " << size;
+    if (utils::cpu::IsSupported(utils::cpu::Isa::kAvx2)) {
+      EXPECT_NEAR(detail::DotAvx2(lhs.data(), rhs.data(), size), expected, tolerance) << "size " << size;
+    }
+    if (utils::cpu::IsSupported(utils::cpu::Isa::kAvx512)) {
+      EXPECT_NEAR(detail::DotAvx512(lhs.data(), rhs.data(), size), expected, tolerance) << "size " << size;
+    }
+#endif
+  }
+}
+
+UTEST(DotProduct, ActiveIsa) {
+  const auto isa = utils::cpu::ActiveIsa();
+  EXPECT_EQ(isa, utils::cpu::DetectIsa());
+  EXPECT_TRUE(utils::cpu::IsSupported(isa));
+  EXPECT_NE(utils::cpu::ToString(isa), "unknown");
+}
+
+}  // namespace
@@ -0,0 +1,18 @@
+#include <userver/utest/utest.hpp>
+#include <utils/fnv1a.hpp>
+
+namespace {
+
+using utils::Fnv1a;
+
+// Reference values of the FNV-1a specification, a changed value would orphan every stored hash
+static_assert(Fnv1a("") == 0xcbf29ce484222325ull);
+static_assert(Fnv1a("a") == 0xaf63dc4c8601ec8cull);
+static_assert(Fnv1a("foobar") == 0x85944171f73967e8ull);
+
+UTEST(Fnv1a, ContinuesAPreviousHash) {
+  EXPECT_EQ(Fnv1a("bar", Fnv1a("foo")), Fnv1a("foobar"));
+  EXPECT_NE(Fnv1a("сессия-1"), Fnv1a("сессия-2"));
+}
+
+}  // namespace
@@ -0,0 +1,70 @@
+#include <userver/utest/utest.hpp>
+#include <utils/random_sampling.hpp>
+
+namespace {
+
+using utils::AliasTable;
+
+UTEST(AliasTable, MatchesWeights) {
+  const std::vector<double> weights = {1.0, 2.0, 3.0, 0.0, 4.0};
+  const AliasTable table(weights);
+  ASSERT_EQ(table.Size(), weights.size());
+
+  constexpr size_t kDraws = 1'000'000;
+  std::mt19937_64 generator(42);
+  std::vector<size_t> counts(weights.size());
+  for (size_t i = 0; i < kDraws; ++i) ++counts[table(generator)];
+
+  EXPECT_EQ(counts[3], 0);
+  for (size_t i = 0; i < weights.size(); ++i) {
+    const double expected = weights[i] / 10.0;
+    EXPECT_NEAR(static_cast<double>(counts[i]) / kDraws, expected, 0.005) << "index " << i;
+  }
+}
+
+UTEST(AliasTable, IsUniformForZeroWeights) {
+  const std::vector<double> weights(4, 0.0);
+  const AliasTable table(weights);
+
+  std::mt19937_64 generator(7);
+  std::vector<size_t> counts(weights.size());
+  for (size_t i = 0; i < 400'000; ++i) ++counts[table(generator)];
+  for (const size_t count : counts) EXPECT_NEAR(count / 400'000.0, 0.25, 0.005);
+}
+
+UTEST(AliasTable, SampleIsDeterministic) {
+  const std::vector<double> weights = {5.0, 1.0, 1.0};
+  const AliasTable table(weights);
+  for (uint64_t key = 0; key < 1000; ++key) {
+    const uint64_t bits = utils::SplitMix64(key);
+    EXPECT_EQ(table.Sample(bits), table.Sample(bits));
+    EXPECT_LT(table.Sample(bits), weights.size());
+  }
+}
+
+UTEST(SampleWithoutReplacement, ReturnsDistinctIndices) {
+  std::mt19937_64 generator(1);
+  for (const size_t count : {0, 1, 10, 99, 100, 150}) {
+    auto sample = utils::SampleWithoutReplacement(100, count, generator);
+    EXPECT_EQ(sample.size(), std::min<size_t>(count, 100));
+
+    std::sort(sample.begin(), sample.end());
+    EXPECT_TRUE(std::adjacent_find(sample.begin(), sample.end()) == sample.end());
+    if (!sample.empty()) {
+      EXPECT_LT(sample.back(), 100);
+    }
+  }
+}
+
+UTEST(SampleWithoutReplacement, IsUniform) {
+  std::mt19937_64 generator(3);
+  std::vector<size_t> counts(10);
+  for (size_t i = 0; i < 100'000; ++i) {
+    for (const size_t index : utils::SampleWithoutReplacement(10, 3, generator)) ++counts[index];
+  }
+
+  // Every index is in a sample with probability 3/10
+  for (const size_t count : counts) EXPECT_NEAR(count / 100'000.0, 0.3, 0.01);
+}
+
+}  // namespace
@@ -0,0 +1,52 @@
+#include <userver/utest/utest.hpp>
+#include <utils/request_arena.hpp>
+
+#include <string>
+
+namespace {
+
+using utils::RequestArena;
+
+UTEST(RequestArena, ServesSmallRequestsFromTheSlab) {
+  RequestArena arena;
+  std::pmr::string word(&arena);
+  word.assign(100, 'x');
+  std::pmr::vector<int> values(&arena);
+  values.resize(64);
+
+  EXPECT_EQ(arena.Allocations(), 2);
+  EXPECT_GE(arena.AllocatedBytes(), 101 + 64 * sizeof(int));
+  EXPECT_EQ(arena.UpstreamAllocations(), 0);
+}
+
+UTEST(RequestArena, CountsOverflowBeyondTheSlab) {
+  RequestArena arena;
+  std::pmr::vector<char> large(&arena);
+  large.resize(RequestArena::kSlabSize * 2);
+
+  EXPECT_EQ(arena.Allocations(), 1);
+  EXPECT_GE(arena.UpstreamAllocations(), 1);
+}
+
+UTEST(RequestArena, ReusesSlabsOfFinishedRequests) {
+  const void* first = nullptr;
+  {
+    RequestArena arena;
+    first = arena.allocate(16);
+  }
+
+  RequestArena arena;
+  EXPECT_EQ(arena.allocate(16), first);
+}
+
+UTEST(RequestArena, NestedArenasGetSeparateSlabs) {
+  RequestArena outer;
+  RequestArena inner;
+  const auto* outer_block = static_cast<const std::byte*>(outer.allocate(16));
+  const auto* inner_block = static_cast<const std::byte*>(inner.allocate(16));
+
+  // Requests suspended on the same thread must not share memory
+  EXPECT_GE(std::abs(outer_block - inner_block), static_cast<std::ptrdiff_t>(RequestArena::kSlabSize - 16));
+}
+
+}  // namespace
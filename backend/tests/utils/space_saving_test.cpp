@@ -0,0 +1,46 @@
+#include <userver/utest/utest.hpp>
+#include <utils/space_saving.hpp>
+
+namespace {
+
+using utils::SpaceSaving;
+
+UTEST(SpaceSaving, IsExactBelowCapacity) {
+  SpaceSaving<int> top(4);
+  for (int i = 0; i < 3; ++i) top.Add(1);
+  top.Add(2, 5);
+  top.Add(3);
+
+  const auto entries = top.Top(10);
+  ASSERT_EQ(entries.size(), 3);
+  EXPECT_EQ(entries[0].key, 2);
+  EXPECT_EQ(entries[0].count, 5);
+  EXPECT_EQ(entries[1].key, 1);
+  EXPECT_EQ(entries[1].count, 3);
+  EXPECT_EQ(entries[1].error, 0);
+  EXPECT_EQ(top.Total(), 9);
+}
+
+UTEST(SpaceSaving, KeepsHeavyHittersInALongTail) {
+  SpaceSaving<int> top(8);
+
+  // Two heavy keys among a thousand keys seen once each
+  for (int i = 0; i < 1000; ++i) {
+    top.Add(1000 + i);
+    if (i % 4 == 0) top.Add(1);
+    if (i % 5 == 0) top.Add(2);
+  }
+
+  const auto entries = top.Top(2);
+  ASSERT_EQ(entries.size(), 2);
+  EXPECT_EQ(entries[0].key, 1);
+  EXPECT_EQ(entries[1].key, 2);
+
+  // count - error never exceeds the true frequency, count never falls below it
+  EXPECT_GE(entries[0].count, 250);
+  EXPECT_LE(entries[0].count - entries[0].error, 250);
+  EXPECT_GE(entries[1].count, 200);
+  EXPECT_LE(entries[1].count - entries[1].error, 200);
+}
+
+}  // namespace
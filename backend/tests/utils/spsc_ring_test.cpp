@@ -0,0 +1,66 @@
+#include <userver/utest/utest.hpp>
+#include <utils/spsc_ring.hpp>
+
+#include <thread>
+
+namespace {
+
+using utils::SpscRing;
+
+UTEST(SpscRing, RoundsCapacityUpToPowerOfTwo) {
+  EXPECT_EQ(SpscRing<int>(0).Capacity(), 2);
+  EXPECT_EQ(SpscRing<int>(5).Capacity(), 8);
+  EXPECT_EQ(SpscRing<int>(16).Capacity(), 16);
+}
+
+UTEST(SpscRing, PreservesOrderAcrossWrapAround) {
+  SpscRing<int> ring(4);
+  int next_push = 0;
+  int next_pop = 0;
+
+  // Alternating partial fills and drains move the indices around the ring many times
+  for (int round = 0; round < 10; ++round) {
+    while (ring.TryPush(next_push)) ++next_push;
+    EXPECT_EQ(ring.Size(), 4);
+
+    int value = -1;
+    for (int i = 0; i < 3; ++i) {
+      ASSERT_TRUE(ring.TryPop(value));
+      EXPECT_EQ(value, next_pop++);
+    }
+  }
+
+  int value = -1;
+  while (ring.TryPop(value)) {
+    EXPECT_EQ(value, next_pop++);
+  }
+  EXPECT_EQ(next_pop, next_push);
+  EXPECT_EQ(ring.Size(), 0);
+}
+
+UTEST(SpscRing, TransfersEverythingBetweenThreads) {
+  constexpr uint64_t kCount = 1'000'000;
+  SpscRing<uint64_t> ring(1024);
+
+  std::thread producer([&] {
+    for (uint64_t i = 0; i < kCount; ++i) {
+      while (!ring.TryPush(i)) std::this_thread::yield();
+    }
+  });
+
+  uint64_t expected = 0;
+  uint64_t value = 0;
+  while (expected < kCount) {
+    if (!ring.TryPop(value)) {
+      std::this_thread::yield();
+      continue;
+    }
+    ASSERT_EQ(value, expected);
+    ++expected;
+  }
+
+  producer.join();
+  EXPECT_FALSE(ring.TryPop(value));
+}
+
+}  // namespace
@@ -30,6 +30,14 @@ UTEST(Utf8Utils, CharLen) {
   EXPECT_EQ(CharLen(emoji, 0), 4);
 }
 
+UTEST(Utf8Utils, DecodeCodePoint) {
+  EXPECT_EQ(DecodeCodePoint("a", 0), U'a');
+  EXPECT_EQ(DecodeCodePoint("ё", 0), U'ё');
+  EXPECT_EQ(DecodeCodePoint("€", 0), U'€');
+  EXPECT_EQ(DecodeCodePoint("😀", 0), U'😀');
+  EXPECT_EQ(DecodeCodePoint("дом", 2), U'о');
+}
+
 // Test cases for UTF-8 character counting
 UTEST(Utf8Utils, CharCount) {
   // Empty string
@@ -79,6 +87,120 @@ UTEST(Utf8Utils, ToLower) {
   EXPECT_EQ(ToLower(mixed), mixed_lower);
 }
 
+// Long inputs cross the vector block boundaries and must match the byte-by-byte implementation
+UTEST(Utf8Utils, ToLowerMatchesScalar) {
+  constexpr std::string_view pieces[] = {"ПРИВЕТ", "Ёлка", "ЁЖИК", "Мир", "abcXYZ", "ё",
+                                         "Я", "дом_NOUN", " ", "€", "😀"};
+
+  std::string input;
+  for (size_t i = 0; i < 200; ++i) {
+    input += pieces[(i * 7) % std::size(pieces)];
+
+    std::string expected(input.size(), '\0');
+    detail::ToLowerScalar(input, expected.data());
+    EXPECT_EQ(ToLower(input), expected);
+
+    std::string in_place = input;
+    ToLowerInPlace(in_place);
+    EXPECT_EQ(in_place, expected);
+  }
+}
+
+#if UTILS_CPU_DISPATCH
+// Every compiled kernel is checked, not only the one the host dispatches to
+UTEST(Utf8Utils, SimdVariantsMatchScalar) {
+  constexpr std::string_view pieces[] = {"ПРИВЕТ", "Ёлка", "Мир", "abcXYZ", "ё", "дом_NOUN", "Ж", "_"};
+
+  std::string input;
+  for (size_t i = 0; i < 120; ++i) {
+    input += pieces[(i * 5) % std::size(pieces)];
+
+    std::string expected(input.size(), '\0');
+    detail::ToLowerScalar(input, expected.data());
+
+    std::string lowered(input.size(), '\0');
+    const bool two_byte = detail::sse2::IsTwoByteUtf8Simd(input.data(), input.size());
+    detail::sse2::ToLowerSimd<false>(input.data(), input.size(), lowered.data());
+    EXPECT_EQ(lowered, expected);
+    EXPECT_TRUE(two_byte);
+
+    if (utils::cpu::IsSupported(utils::cpu::Isa::kAvx2)) {
+      EXPECT_EQ(detail::avx2::ToLowerSimd<true>(input.data(), input.size(), lowered.data()), two_byte);
+      EXPECT_EQ(lowered, expected);
+      EXPECT_EQ(detail::avx2::IsTwoByteUtf8Simd(input.data(), input.size()), two_byte);
+    }
+  }
+
+  // Anything outside two-byte UTF-8 is rejected by every variant, wherever it sits
+  for (const std::string_view suffix : {"€", "😀", "\xD0", "\x90"}) {
+    const std::string broken = input + std::string(suffix);
+    EXPECT_FALSE(detail::sse2::IsTwoByteUtf8Simd(broken.data(), broken.size()));
+    if (utils::cpu::IsSupported(utils::cpu::Isa::kAvx2)) {
+      EXPECT_FALSE(detail::avx2::IsTwoByteUtf8Simd(broken.data(), broken.size()));
+    }
+  }
+}
+#endif
+
+UTEST(Utf8Utils, ToLowerIntoBuffer) {
+  constexpr std::string_view upper = "ЁЖИК_NOUN";
+  std::array<char, 64> buffer{};
+  ToLower(upper, buffer.data());
+  EXPECT_EQ(std::string_view(buffer.data(), upper.size()), "ёжик_noun");
+
+  std::string word = "ПриВЕТ123HeLLo";
+  ToLowerInPlace(word);
+  EXPECT_EQ(word, "привет123hello");
+}
+
+UTEST(Utf8Utils, IsValid) {
+  EXPECT_TRUE(IsValid(""));
+  EXPECT_TRUE(IsValid("hello"));
+  EXPECT_TRUE(IsValid("привет"));
+  EXPECT_TRUE(IsValid("привет😀world€"));
+  EXPECT_TRUE(IsValid(std::string(100, 'a') + "ёжик"));
+
+  EXPECT_FALSE(IsValid("\xD0"));                  // Truncated sequence
+  EXPECT_FALSE(IsValid("пр\xD0"));                // Truncated at the end
+  EXPECT_FALSE(IsValid("\x90"));                  // Stray continuation byte
+  EXPECT_FALSE(IsValid("\xC0\xAF"));              // Overlong encoding
+  EXPECT_FALSE(IsValid("\xED\xA0\x80"));          // Surrogate
+  EXPECT_FALSE(IsValid("\xF4\x90\x80\x80"));      // Above U+10FFFF
+  EXPECT_FALSE(IsValid("\xFF"));                  // Never valid
+  EXPECT_FALSE(IsValid(std::string(100, 'a') + "\xD0\xD0"));
+}
+
+UTEST(Utf8Utils, ToLowerValidated) {
+  std::string word = "ЁЖИК";
+  EXPECT_TRUE(ToLowerValidatedInPlace(word));
+  EXPECT_EQ(word, "ёжик");
+
+  std::string with_emoji = std::string(40, 'A') + "😀";
+  EXPECT_TRUE(ToLowerValidatedInPlace(with_emoji));
+  EXPECT_EQ(with_emoji, std::string(40, 'a') + "😀");
+
+  std::string malformed = std::string(40, 'A') + "\xD0";
+  EXPECT_FALSE(ToLowerValidatedInPlace(malformed));
+}
+
+UTEST(Utf8Utils, Fold) {
+  const auto fold = [](std::string_view str) {
+    std::string result(str.size(), '\0');
+    result.resize(Fold(str, result.data()));
+    return result;
+  };
+
+  EXPECT_EQ(fold("Дом"), "дом");
+  EXPECT_EQ(fold("ёжик"), "ежик");
+  EXPECT_EQ(fold("ЁЖИК"), "ежик");
+  EXPECT_EQ(fold("  Ёлка\r\n"), "елка");
+  EXPECT_EQ(fold("   "), "");
+  EXPECT_EQ(fold("HeLLo"), "hello");
+
+  EXPECT_TRUE(FoldedEqual("ёжик", "Ежик"));
+  EXPECT_FALSE(FoldedEqual("ёжик", "ежики"));
+}
+
 // Test cases for common prefix length calculation
 UTEST(Utf8Utils, CommonPrefixLength) {
   // ASCII strings
@@ -108,6 +230,34 @@ UTEST(Utf8Utils, CommonPrefixLength) {
   EXPECT_EQ(CommonPrefixLength(prefix, full), 3);
 }
 
+UTEST(Utf8Utils, CodePointPrefix) {
+  const auto prefix = MakeCodePointPrefix("ёж_NOUN");
+  EXPECT_EQ(prefix.code_points[0], U'ё');
+  EXPECT_EQ(prefix.code_points[1], U'ж');
+  EXPECT_EQ(prefix.code_points[2], U'_');
+  EXPECT_EQ(prefix.code_points[7], 0);
+
+  // Matches the string version up to the prefix size
+  constexpr std::string_view words[] = {"",          "при",      "привет",         "примерно",      "привет123",
+                                        "привет456", "hello",    "help",           "абракадабра",   "абракадабры",
+                                        "кот_NOUN",  "кот",      "котёнок",        "котенок",       "\xD0",
+                                        "при\xD0",   "приветик", "приветики_NOUN", "a\xC3\xA9" "b", "a\xC3\xA9" "c"};
+  for (const auto lhs : words) {
+    for (const auto rhs : words) {
+      const size_t expected = std::min(CommonPrefixLength(lhs, rhs), CodePointPrefix::kSize);
+      EXPECT_EQ(CommonPrefixLength(MakeCodePointPrefix(lhs), MakeCodePointPrefix(rhs)), expected)
+          << lhs << " / " << rhs;
+#if UTILS_CPU_DISPATCH
+      const auto mask = detail::MatchingLanesScalar(MakeCodePointPrefix(lhs), MakeCodePointPrefix(rhs));
+      EXPECT_EQ(detail::MatchingLanesSse2(MakeCodePointPrefix(lhs), MakeCodePointPrefix(rhs)), mask);
+      if (utils::cpu::IsSupported(utils::cpu::Isa::kAvx2)) {
+        EXPECT_EQ(detail::MatchingLanesAvx2(MakeCodePointPrefix(lhs), MakeCodePointPrefix(rhs)), mask);
+      }
+#endif
+    }
+  }
+}
+
 // Test fallback similarity calculations
 UTEST(Utf8Utils, FallbackSimilarity) {
   // The test expects a specific implementation, so we'll adapt our test
@@ -0,0 +1,55 @@
+import argparse
+import json
+import struct
+import sys
+
+MAGIC = b"CTXEVLOG"
+HEADER = struct.Struct("<8sII")
+# Layout of contexto::GameEvent: timestamp_ns, session, word_index, rank, type, flags
+RECORD = struct.Struct("<qQIhBB")
+EVENT_TYPES = {1: "new-game", 2: "guess", 3: "give-up"}
+FLAGS = {1: "daily", 2: "pooled", 4: "corrected", 8: "bare-word", 16: "tiered"}
+# Version 2 hashes sessions with FNV-1a; version 1 used the std::hash of the writing binary, so its sessions
+# only join with files written by the same build
+VERSIONS = (1, 2)
+
+
+def read_events(path):
+    """
+    Yield the records of one game event file as dicts
+    """
+    with open(path, "rb") as f:
+        magic, version, record_size = HEADER.unpack(f.read(HEADER.size))
+        if magic != MAGIC:
+            raise ValueError(f"{path} is not a game event log")
+        if version not in VERSIONS or record_size != RECORD.size:
+            raise ValueError(f"Unsupported event log version {version} with {record_size}-byte records")
+
+        while chunk := f.read(RECORD.size * 4096):
+            # A file cut by a crash may end in a partial record
+            usable = len(chunk) - len(chunk) % RECORD.size
+            for timestamp_ns, session, word_index, rank, event_type, flags in RECORD.iter_unpack(chunk[:usable]):
+                event = {
+                    "timestamp_ns": timestamp_ns,
+                    "session": f"{session:016x}",
+                    "type": EVENT_TYPES.get(event_type, str(event_type)),
+                    "word_index": word_index,
+                    "flags": [name for bit, name in FLAGS.items() if flags & bit],
+                }
+                if event_type == 2:
+                    event["rank"] = rank
+                yield event
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode binary game event logs into JSON lines")
+    parser.add_argument("files", nargs="+", help="event files, e.g. logs/game-events.bin.1 logs/game-events.bin")
+    args = parser.parse_args()
+
+    for path in args.files:
+        for event in read_events(path):
+            sys.stdout.write(json.dumps(event) + "\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,163 @@
+import argparse
+import random
+from pathlib import Path
+
+# Part-of-speech tags of the embedding model; nouns dominate like in the real vocabulary
+POS_WEIGHTS = {"NOUN": 0.7, "ADJ": 0.15, "VERB": 0.1, "ADV": 0.05}
+
+RUSSIAN_LOWER = "абвгдеёжзийклмнопрстуфхцчшщъыьэюя"
+
+
+def read_words(dictionary_file, limit):
+    """
+    Read lemmas from a dictionary file (optional count header, "word_POS" or bare words)
+    """
+    words = []
+    with open(dictionary_file, "r", encoding="utf-8") as f:
+        for line in f:
+            line = line.strip()
+            if not line or line.isdigit():
+                continue
+            word = line.rsplit("_", 1)[0] if "_" in line else line
+            words.append(word)
+            if len(words) == limit:
+                break
+    return words
+
+
+def generate_embeddings(words, dimension, clusters, rng):
+    """
+    Assign every word a vector near one of a few topic centroids, so that similarities cover
+    the whole rank curve instead of clustering around zero
+    """
+    centroids = [[rng.gauss(0.0, 1.0) for _ in range(dimension)] for _ in range(clusters)]
+
+    entries = []
+    for word in words:
+        pos_tags = [pos for pos in POS_WEIGHTS if pos == "NOUN" or rng.random() < POS_WEIGHTS[pos]]
+        for pos in pos_tags:
+            centroid = centroids[rng.randrange(clusters)]
+            spread = rng.uniform(0.3, 1.5)
+            vector = [c + rng.gauss(0.0, spread) for c in centroid]
+            norm = sum(v * v for v in vector) ** 0.5
+            entries.append((f"{word}_{pos}", [v / norm for v in vector]))
+
+    rng.shuffle(entries)
+    return entries
+
+
+def write_embeddings(entries, dimension, output_file):
+    with open(output_file, "w", encoding="utf-8") as f:
+        f.write(f"{len(entries)} {dimension}\n")
+        for word, vector in entries:
+            f.write(word)
+            f.write(" ")
+            f.write(" ".join(f"{v:.5f}" for v in vector))
+            f.write("\n")
+
+
+def misspell(word, rng):
+    """
+    Apply one random edit, the way players mistype words
+    """
+    chars = list(word)
+    position = rng.randrange(len(chars))
+    edit = rng.randrange(3)
+    if edit == 0 and len(chars) > 2:
+        del chars[position]
+    elif edit == 1:
+        chars[position] = rng.choice(RUSSIAN_LOWER)
+    else:
+        chars.insert(position, rng.choice(RUSSIAN_LOWER))
+    return "".join(chars)
+
+
+def player_spelling(word, rng):
+    """
+    Spellings the guess endpoint has to normalize: capitalized, upper case, е instead of ё, with POS
+    """
+    roll = rng.random()
+    if roll < 0.15:
+        return word.capitalize()
+    if roll < 0.2:
+        return word.upper()
+    if roll < 0.25 and "ё" in word:
+        return word.replace("ё", "е")
+    if roll < 0.3:
+        return f"{word}_NOUN"
+    return word
+
+
+def generate_trace(words, games, rng):
+    """
+    A trace is a list of games; each game is a sequence of "new-game", "guess <word>",
+    "complete <prefix>" and "give-up" steps
+    """
+    lines = []
+    for _ in range(games):
+        lines.append("new-game")
+        guesses = max(1, int(rng.expovariate(1.0 / 25.0)))
+        for _ in range(guesses):
+            word = rng.choice(words)
+            roll = rng.random()
+            if roll < 0.1:
+                # Typed prefixes feed the autocomplete endpoint
+                prefix_length = rng.randint(1, min(4, len(word)))
+                lines.append(f"complete {word[:prefix_length]}")
+            elif roll < 0.2:
+                lines.append(f"guess {misspell(word, rng)}")
+            elif roll < 0.22:
+                lines.append("guess " + "".join(rng.choice(RUSSIAN_LOWER) for _ in range(rng.randint(3, 9))))
+            else:
+                lines.append(f"guess {player_spelling(word, rng)}")
+        if rng.random() < 0.3:
+            lines.append("give-up")
+    return lines
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Generate a synthetic workload for PGO training and benchmarks")
+    parser.add_argument("--dictionary", "-d", required=True, help="Dictionary file with the vocabulary")
+    parser.add_argument("--output-dir", "-o", required=True, help="Directory for the generated files")
+    parser.add_argument("--words", type=int, default=20000, help="Vocabulary size")
+    parser.add_argument("--dimension", type=int, default=300, help="Embedding dimension")
+    parser.add_argument("--clusters", type=int, default=64, help="Number of topic centroids")
+    parser.add_argument("--games", type=int, default=2000, help="Number of games in each guess trace")
+    parser.add_argument("--seed", type=int, default=42, help="Random seed")
+    parser.add_argument("--verbose", "-v", action="store_true", help="Print progress information")
+    args = parser.parse_args()
+
+    rng = random.Random(args.seed)
+    output_dir = Path(args.output_dir)
+    output_dir.mkdir(parents=True, exist_ok=True)
+
+    words = read_words(args.dictionary, args.words)
+    if not words:
+        print(f"Error: no words found in {args.dictionary}")
+        return 1
+
+    if args.verbose:
+        print(f"Generating {args.dimension}-dimensional embeddings for {len(words)} words...")
+    entries = generate_embeddings(words, args.dimension, args.clusters, rng)
+    write_embeddings(entries, args.dimension, output_dir / "embeddings.vec")
+
+    with open(output_dir / "dictionary.txt", "w", encoding="utf-8") as f:
+        f.write(f"{len(words)}\n")
+        f.writelines(f"{word}_NOUN\n" for word in words)
+
+    # Benchmarks replay games the profile was not trained on
+    traces = {
+        "training_trace.txt": generate_trace(words, args.games, rng),
+        "benchmark_trace.txt": generate_trace(words, args.games, random.Random(args.seed + 1)),
+    }
+    for name, trace in traces.items():
+        with open(output_dir / name, "w", encoding="utf-8") as f:
+            f.writelines(f"{line}\n" for line in trace)
+
+    if args.verbose:
+        print(f"Wrote {len(entries)} embeddings and guess traces to {output_dir}")
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
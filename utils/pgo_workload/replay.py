@@ -0,0 +1,145 @@
+import argparse
+import http.client
+import json
+import multiprocessing
+import time
+import urllib.parse
+
+
+def read_games(trace_file):
+    """
+    Split a guess trace into games, each starting with a "new-game" step
+    """
+    games = []
+    with open(trace_file, "r", encoding="utf-8") as f:
+        for line in f:
+            line = line.strip()
+            if not line:
+                continue
+            if line == "new-game" or not games:
+                games.append([])
+            games[-1].append(line)
+    return games
+
+
+class Player:
+    """
+    One keep-alive connection with its own session cookie, like a browser tab
+    """
+
+    def __init__(self, host, port):
+        self.connection = http.client.HTTPConnection(host, port, timeout=30)
+        self.session_id = None
+
+    def request(self, method, path, body=None):
+        headers = {"Content-Type": "application/json"}
+        if self.session_id:
+            headers["Cookie"] = f"session_id={self.session_id}"
+        # Bytes bodies go out in the same packet as the headers, which avoids Nagle delays
+        self.connection.request(method, path, body=body.encode() if body else None, headers=headers)
+        response = self.connection.getresponse()
+        return response.status, response.read()
+
+    def play(self, step):
+        if step == "new-game":
+            status, body = self.request("POST", "/api/new-game", "{}")
+            if status == 200:
+                self.session_id = json.loads(body).get("session_id", self.session_id)
+            return status
+        if step == "give-up":
+            return self.request("POST", "/api/give-up", "{}")[0]
+
+        action, _, argument = step.partition(" ")
+        if action == "guess":
+            return self.request("POST", "/api/guess", json.dumps({"word": argument}))[0]
+        if action == "complete":
+            return self.request("GET", "/api/complete?prefix=" + urllib.parse.quote(argument))[0]
+        raise ValueError(f"Unknown trace step: {step}")
+
+
+def run_worker(worker_id, workers, games, host, port, duration, passes, results):
+    try:
+        results.put(replay_games(games[worker_id::workers], host, port, duration, passes))
+    except (OSError, http.client.HTTPException) as e:
+        print(f"Error: player {worker_id} failed: {e}")
+        results.put(([], 1))
+
+
+def replay_games(assigned, host, port, duration, passes):
+    player = Player(host, port)
+    latencies = []
+    errors = 0
+
+    deadline = time.perf_counter() + duration if duration > 0 else None
+    completed_passes = 0
+    while assigned and (deadline is not None or completed_passes < passes):
+        for game in assigned:
+            for step in game:
+                start = time.perf_counter()
+                status = player.play(step)
+                latencies.append(time.perf_counter() - start)
+                # 4xx is expected for unknown words and finished games, anything else is a failure
+                if status >= 500:
+                    errors += 1
+            if deadline is not None and time.perf_counter() >= deadline:
+                break
+        completed_passes += 1
+        if deadline is not None and time.perf_counter() >= deadline:
+            break
+
+    return latencies, errors
+
+
+def percentile(sorted_values, fraction):
+    if not sorted_values:
+        return 0.0
+    return sorted_values[min(len(sorted_values) - 1, int(len(sorted_values) * fraction))]
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Replay a guess trace against a running server")
+    parser.add_argument("--trace", "-t", required=True, help="Trace file with one step per line")
+    parser.add_argument("--host", default="127.0.0.1", help="Server host")
+    parser.add_argument("--port", "-p", type=int, default=8080, help="Server port")
+    parser.add_argument("--workers", "-w", type=int, default=multiprocessing.cpu_count(),
+                        help="Concurrent players, each in its own process")
+    parser.add_argument("--duration", type=float, default=0.0,
+                        help="Replay for this many seconds instead of a fixed number of passes")
+    parser.add_argument("--passes", type=int, default=1, help="Passes over the trace when no duration is set")
+    args = parser.parse_args()
+
+    games = read_games(args.trace)
+    if not games:
+        print(f"Error: no games found in {args.trace}")
+        return 1
+
+    # Players replay disjoint games, so one pass replays every game of the trace exactly once
+    results = multiprocessing.Queue()
+    processes = [
+        multiprocessing.Process(target=run_worker,
+                                args=(i, args.workers, games, args.host, args.port, args.duration, args.passes,
+                                      results))
+        for i in range(args.workers)
+    ]
+
+    start = time.perf_counter()
+    for process in processes:
+        process.start()
+    collected = [results.get() for _ in processes]
+    for process in processes:
+        process.join()
+    elapsed = time.perf_counter() - start
+
+    latencies = sorted(latency for worker_latencies, _ in collected for latency in worker_latencies)
+    errors = sum(worker_errors for _, worker_errors in collected)
+    throughput = len(latencies) / elapsed if elapsed > 0 else 0.0
+
+    # The last line is machine-readable for scripts/pgo.sh
+    print(f"requests={len(latencies)} errors={errors} seconds={elapsed:.2f} "
+          f"p50_us={percentile(latencies, 0.5) * 1e6:.0f} p99_us={percentile(latencies, 0.99) * 1e6:.0f}")
+    print(f"throughput_rps={throughput:.1f}")
+    return 1 if errors else 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())